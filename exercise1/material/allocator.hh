@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace scprog
+{
+  /// alignment of all vector and matrix storage, the size of a cache line
+  constexpr std::size_t cache_line_size = 64;
+
+  /// size of a transparent huge page on x86-64 Linux
+  constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+
+  /// mutable access to the flag whether large allocations request transparent huge pages
+  inline bool& huge_pages_ref()
+  {
+    static bool enabled = true;
+    return enabled;
+  }
+
+  /// return whether large allocations request transparent huge pages
+  inline bool huge_pages()
+  {
+    return huge_pages_ref();
+  }
+
+  /// enable or disable transparent huge pages for subsequent large allocations
+  inline void set_huge_pages(bool enabled)
+  {
+    huge_pages_ref() = enabled;
+  }
+
+  /// mutable access to the number of allocations by \ref AlignedAllocator
+  inline std::atomic<std::size_t>& num_allocations_ref()
+  {
+    static std::atomic<std::size_t> n{0};
+    return n;
+  }
+
+  /// return the number of allocations of vector and matrix storage since program start
+  inline std::size_t num_allocations()
+  {
+    return num_allocations_ref();
+  }
+
+  /// return the offset of the next large allocation from its huge-page boundary
+  /**
+   * Consecutive large allocations are shifted by different multiples of 9 cache lines
+   * within the first 64 cache lines modulo 4 KiB. Otherwise, all vectors would start at the
+   * same address modulo the page size and kernels streaming through several vectors would
+   * suffer from cache set conflicts and 4K aliasing.
+   **/
+  inline std::size_t next_allocation_offset()
+  {
+    static std::atomic<unsigned> counter{0};
+    return (counter++ % 64) * 9 * cache_line_size;
+  }
+
+
+  /// Allocator for the storage of vectors and matrices
+  /**
+   * Memory is aligned to a cache line, so that rows and vectors never start with a split
+   * cache-line load. Allocations of at least \ref huge_page_size bytes start close to a
+   * huge-page boundary, shifted by \ref next_allocation_offset(), and are, on Linux, marked
+   * with `madvise(MADV_HUGEPAGE)` if \ref huge_pages() is enabled, reducing TLB misses for
+   * large matrices.
+   *
+   * Elements are default-initialized, i.e., for arithmetic types the memory is not touched
+   * on construction. The containers fill the entries in parallel with the same partition
+   * as their compute kernels, such that pages are first touched by the thread that later
+   * works on them.
+   **/
+  template <class T>
+  class AlignedAllocator
+  {
+  public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind { using other = AlignedAllocator<U>; };
+
+    AlignedAllocator() = default;
+
+    template <class U>
+    AlignedAllocator(AlignedAllocator<U> const&) noexcept {}
+
+    /// allocate uninitialized memory for n elements
+    T* allocate(std::size_t n)
+    {
+      std::size_t bytes = n * sizeof(T);
+      void* p = nullptr;
+      ++num_allocations_ref();
+      if (bytes < huge_page_size) {
+        if (posix_memalign(&p, cache_line_size, bytes) != 0)
+          throw std::bad_alloc{};
+        return static_cast<T*>(p);
+      }
+
+      std::size_t offset = next_allocation_offset();
+      if (posix_memalign(&p, huge_page_size, bytes + offset) != 0)
+        throw std::bad_alloc{};
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+      if (huge_pages())
+        madvise(p, bytes + offset, MADV_HUGEPAGE);
+#endif
+      return reinterpret_cast<T*>(static_cast<char*>(p) + offset);
+    }
+
+    /// release the memory allocated by \ref allocate
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+      // large allocations are shifted by less than a huge page from the allocated block
+      if (n * sizeof(T) >= huge_page_size)
+        p = reinterpret_cast<T*>(reinterpret_cast<std::uintptr_t>(p) & ~(huge_page_size - 1));
+      std::free(p);
+    }
+
+    /// default-initialize an element, i.e., leave arithmetic types uninitialized
+    template <class U>
+    void construct(U* p) noexcept(noexcept(::new((void*)p) U))
+    {
+      ::new((void*)p) U;
+    }
+
+    /// construct an element from the given arguments
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args)
+    {
+      ::new((void*)p) U(std::forward<Args>(args)...);
+    }
+
+    friend bool operator==(AlignedAllocator const&, AlignedAllocator const&) { return true; }
+    friend bool operator!=(AlignedAllocator const&, AlignedAllocator const&) { return false; }
+  };
+
+} // end namespace scprog
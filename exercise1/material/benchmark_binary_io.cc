@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include "binary_io.hh"
+#include "linear_algebra.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Write the matrix as text: the dimensions followed by the entries row by row
+void write_text(std::string const& filename, DenseMatrix const& A)
+{
+  std::ofstream out(filename);
+  out << std::setprecision(std::numeric_limits<double>::max_digits10);
+  out << A.rows() << " " << A.cols() << "\n";
+  for (std::size_t r = 0; r < A.rows(); ++r) {
+    for (std::size_t c = 0; c < A.cols(); ++c)
+      out << A(r,c) << " ";
+    out << "\n";
+  }
+}
+
+// Parse a matrix written by write_text
+void read_text(std::string const& filename, DenseMatrix& A)
+{
+  std::ifstream in(filename);
+  std::size_t rows = 0, cols = 0;
+  in >> rows >> cols;
+  A.resize(rows, cols);
+  for (std::size_t r = 0; r < rows; ++r)
+    for (std::size_t c = 0; c < cols; ++c)
+      in >> A(r,c);
+}
+
+// Solve with the Laplacian matrix and return the time and number of iterations
+template <class Matrix>
+void solve(std::string const& name, Matrix const& A)
+{
+  DenseVector b(A.rows(), 1.0), x(A.rows());
+  BasicIteration iter(b, 10000, 1.e-8);
+  iter.set_quite(true);
+  iter.suppress_resume(true);
+  Timer t;
+  cg(A, x, b, iter);
+  std::cout << "  cg with " << name << ": " << iter.iterations() << " iterations, "
+            << (t.elapsed()*1000.0) << " ms\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t m = argc > 1 ? std::atoi(argv[1]) : 48;
+  std::string prefix = argc > 2 ? argv[2] : "benchmark_binary_io";
+
+  DenseMatrix A;
+  laplacian_setup(A, m, m);
+  std::cout << "dense Laplacian " << A.rows() << "x" << A.cols() << ", "
+            << (A.rows()*A.cols()*sizeof(double) / 1.e6) << " MB:\n";
+
+  write_text(prefix + ".txt", A);
+  write_binary(prefix + ".bin", A);
+
+  Timer t;
+  DenseMatrix A_text;
+  read_text(prefix + ".txt", A_text);
+  std::cout << "  parse text:            " << (t.elapsed()*1000.0) << " ms\n";
+
+  t.reset();
+  DenseMatrix A_copy = MappedDenseMatrix<double>(prefix + ".bin");
+  std::cout << "  map binary and copy:   " << (t.elapsed()*1000.0) << " ms\n";
+
+  t.reset();
+  MappedDenseMatrix<double> A_mapped(prefix + ".bin");
+  std::cout << "  map binary, zero-copy: " << (t.elapsed()*1000.0) << " ms\n";
+
+  // the first solve with the mapped matrix includes reading the pages of the file
+  solve("mapped matrix", A_mapped);
+  solve("owned matrix ", A_copy);
+
+  // a mapped vector used as an operand of an expression must equal the vector in memory
+  DenseVector v(A.rows());
+  for (std::size_t i = 0; i < v.size(); ++i)
+    v[i] = 1.0 / (i + 1.0);
+  write_binary(prefix + ".vec.bin", v);
+  MappedDenseVector<double> v_mapped(prefix + ".vec.bin");
+  DenseVector d = v_mapped + 2.0*v;
+  d -= 3.0*v;
+  std::cout << "  mapped vector in an expression, error: " << d.inf_norm() << "\n";
+
+  std::remove((prefix + ".txt").c_str());
+  std::remove((prefix + ".bin").c_str());
+  std::remove((prefix + ".vec.bin").c_str());
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG linear_algebra.cc binary_io.cc benchmark_binary_io.cc -o benchmark_binary_io
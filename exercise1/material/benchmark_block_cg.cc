@@ -0,0 +1,80 @@
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "linear_algebra.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Solve k systems one after the other and as a block, and report the throughput
+template <class Operator>
+void benchmark(std::string const& name, Operator const& A, std::size_t k, double rtol)
+{
+  std::size_t const N = A.rows();
+  DenseMatrix B(N, k), X(N, k);
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for (std::size_t i = 0; i < N; ++i)
+    for (std::size_t j = 0; j < k; ++j)
+      B(i,j) = dist(gen);
+
+  // 1. one cg call per right-hand side
+  Timer t;
+  int iterations = 0;
+  DenseVector b(N), x(N);
+  for (std::size_t j = 0; j < k; ++j) {
+    for (std::size_t i = 0; i < N; ++i)
+      b[i] = B(i,j);
+    x = 0;
+    BasicIteration iter(b, 10000, rtol);
+    iter.set_quite(true);
+    iter.suppress_resume(true);
+    cg(A, x, b, iter);
+    iterations += iter.iterations();
+  }
+  double t_single = t.elapsed();
+
+  // 2. all right-hand sides as a block
+  std::vector<BasicIteration> iters;
+  for (std::size_t j = 0; j < k; ++j) {
+    for (std::size_t i = 0; i < N; ++i)
+      b[i] = B(i,j);
+    iters.emplace_back(b, 10000, rtol);
+    iters.back().set_quite(true);
+    iters.back().suppress_resume(true);
+  }
+  t.reset();
+  cg_block(A, X, B, iters);
+  double t_block = t.elapsed();
+
+  int block_iterations = 0;
+  for (auto const& iter : iters)
+    block_iterations += iter.iterations();
+
+  std::cout << "  " << name << ", k = " << k << ":\n"
+            << "    cg:       " << (iterations/t_single) << " RHS-iterations/s\n"
+            << "    cg_block: " << (block_iterations/t_block) << " RHS-iterations/s\n"
+            << "    speedup:  " << (t_single / t_block) << "\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 256;
+  std::size_t k_max = argc > 2 ? std::atoi(argv[2]) : 64;
+  double rtol = argc > 3 ? std::atof(argv[3]) : 1.e-6;
+
+  CRSMatrix A;
+  laplacian_setup(A, n, n);
+  LaplacianOperator L(n, n);
+
+  std::cout << "grid " << n << "x" << n << ", rtol " << rtol << ":\n";
+  for (std::size_t k = 1; k <= k_max; k *= 4) {
+    benchmark("CRSMatrix", A, k, rtol);
+    benchmark("LaplacianOperator", L, k, rtol);
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG linear_algebra.cc benchmark_block_cg.cc -o benchmark_block_cg
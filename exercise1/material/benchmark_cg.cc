@@ -0,0 +1,53 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "linear_algebra.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Run a fixed number of iterations of the given cg variant and return the time per iteration
+template <class Operator, class Solver>
+double benchmark(Operator const& A, std::size_t N, int iterations, Solver solver)
+{
+  DenseVector b(N, 1.0), x(N);
+  BasicIteration iter(b, iterations, 0.0, 0.0, iterations);
+  iter.set_quite(true);
+  iter.suppress_resume(true);
+
+  Timer t;
+  solver(A, x, b, iter);
+  return t.elapsed() / iter.iterations();
+}
+
+template <class Operator>
+void compare(std::string const& name, Operator const& A, std::size_t N, int iterations)
+{
+  auto classic = [](auto const& A, auto& x, auto const& b, auto& iter) { return cg(A, x, b, iter); };
+  auto fused = [](auto const& A, auto& x, auto const& b, auto& iter) { return cg_fused(A, x, b, iter); };
+
+  double t_classic = benchmark(A, N, iterations, classic);
+  double t_fused = benchmark(A, N, iterations, fused);
+  std::cout << "  " << name << ":\n"
+            << "    cg:       " << (t_classic*1000.0) << " ms/iteration\n"
+            << "    cg_fused: " << (t_fused*1000.0) << " ms/iteration\n"
+            << "    speedup:  " << (t_classic / t_fused) << "\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 1000;
+  int iterations = argc > 2 ? std::atoi(argv[2]) : 100;
+
+  std::cout << "grid " << n << "x" << n << ", " << iterations << " iterations:\n";
+
+  CRSMatrix A;
+  laplacian_setup(A, n, n);
+  compare("CRSMatrix", A, n*n, iterations);
+
+  LaplacianOperator L(n, n);
+  compare("LaplacianOperator", L, n*n, iterations);
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG linear_algebra.cc benchmark_cg.cc -o benchmark_cg
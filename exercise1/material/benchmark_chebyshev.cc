@@ -0,0 +1,83 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "linear_algebra.hh"
+#include "parallel.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Print iterations, time per iteration, the number of global reductions and the true residual
+template <class Solver>
+void run(std::string const& name, LaplacianOperator const& A, DenseVector const& b,
+         double reductions, Solver solver)
+{
+  DenseVector x(b.size(), 0.0);
+  BasicIteration iter(b, 20000, 1.e-8);
+  iter.set_quite(true);
+  iter.suppress_resume(true);
+
+  Timer t;
+  solver(x, iter);
+  double time = t.elapsed();
+
+  DenseVector r(b.size());
+  A.mult(x, r);
+  r.aypx(-1.0, b);
+  std::cout << "    " << name << ": " << iter.iterations() << " iterations, "
+            << (time*1000.0) << " ms, " << (time*1.e6 / iter.iterations()) << " us/iteration, "
+            << reductions << " reductions/iteration, "
+            << "true residual " << (r.two_norm() / b.two_norm()) << "\n";
+}
+
+int main(int argc, char** argv)
+{
+  int max_threads = argc > 1 ? std::atoi(argv[1]) : int(std::thread::hardware_concurrency());
+
+  // small grids are dominated by the synchronization, large grids by memory bandwidth
+  for (std::size_t n : {64, 256, 512}) {
+    LaplacianOperator A(n, n);
+    DenseVector b(n*n, 1.0);
+
+    // spectral bounds from the Lanczos process, with a safety margin for lambda_max
+    DenseVector v0(n*n);
+    for (std::size_t i = 0; i < n*n; ++i)
+      v0[i] = std::sin(1.0 + 7.0*i) + 0.5;
+    LanczosTridiagonal T;
+    Timer t;
+    lanczos(A, v0, 30, T);
+    double lmax = 1.05 * T.max_eigenvalue();
+
+    // the smallest eigenvalue converges slowly, so take it from a cheap cg solve instead
+    DenseVector x(n*n, 0.0);
+    BasicIteration iter(b, 10000, 1.e-2);
+    iter.set_quite(true);
+    iter.suppress_resume(true);
+    LanczosTridiagonal T_cg;
+    cg(A, x, b, iter, &T_cg);
+    double lmin = 0.99 * T_cg.min_eigenvalue();
+    double t_bounds = t.elapsed();
+
+    std::cout << "grid " << n << "x" << n << ", bounds [" << lmin << ", " << lmax << "] in "
+              << (t_bounds*1000.0) << " ms:\n";
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+      parallel::set_num_threads(threads);
+      std::cout << "  threads " << threads << ":\n";
+      run("cg           ", A, b, 2.0, [&](DenseVector& x, BasicIteration& iter) {
+        cg(A, x, b, iter);
+      });
+      for (int check : {1, 10, 50}) {
+        std::string name = "chebyshev(" + std::to_string(check) + ")";
+        run(name + std::string(13 - name.size(), ' '), A, b, 1.0/check,
+          [&](DenseVector& x, BasicIteration& iter) {
+            chebyshev(A, x, b, iter, lmin, lmax, check);
+          });
+      }
+    }
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -fopenmp linear_algebra.cc benchmark_chebyshev.cc -o benchmark_chebyshev
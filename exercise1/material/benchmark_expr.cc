@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "linear_algebra.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Evaluate the expression repeatedly and report the allocations per evaluation and the time
+template <class F>
+void benchmark(std::string const& name, int repeat, F f)
+{
+  f(); // warm-up
+  std::size_t allocations = num_allocations();
+  Timer t;
+  for (int i = 0; i < repeat; ++i)
+    f();
+  double time = t.elapsed() / repeat;
+  std::cout << "  " << name << ": " << double(num_allocations() - allocations) / repeat
+            << " allocations, " << (time*1000.0) << " ms\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t m = argc > 1 ? std::atoi(argv[1]) : 2048;
+  std::size_t n = argc > 2 ? std::atol(argv[2]) : (std::size_t(1) << 24);
+  int repeat = 10;
+
+  DenseMatrix A(m, m, 1.0 / m);
+  DenseVector x(m, 1.0), b(m, 2.0), r(m);
+
+  std::cout << "residual r = b - A*x, matrix " << m << "x" << m << ":\n";
+  benchmark("eager, temporaries  ", repeat, [&] {
+    DenseVector Ax(m);
+    A.mult(x, Ax);
+    DenseVector tmp(b);
+    tmp -= Ax;
+    r = tmp;
+  });
+  benchmark("mult + aypx         ", repeat, [&] { A.mult(x, r); r.aypx(-1.0, b); });
+  benchmark("expression          ", repeat, [&] { r = b - A*x; });
+
+  DenseVector u(n, 1.0), v(n, 2.0), w(n, 3.0), z(n);
+  std::cout << "update z = u + 2*v - 0.5*w, vectors of size " << n << ":\n";
+  benchmark("eager, temporaries  ", repeat, [&] {
+    DenseVector tmp1(v);
+    tmp1 *= 2.0;
+    DenseVector tmp2(u);
+    tmp2 += tmp1;
+    DenseVector tmp3(w);
+    tmp3 *= 0.5;
+    tmp2 -= tmp3;
+    z = tmp2;
+  });
+  benchmark("copy + axpy         ", repeat, [&] { z = u; z.axpy(2.0, v); z.axpy(-0.5, w); });
+  benchmark("expression          ", repeat, [&] { z = u + 2.0*v - 0.5*w; });
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG linear_algebra.cc benchmark_expr.cc -o benchmark_expr
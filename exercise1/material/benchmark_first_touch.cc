@@ -0,0 +1,59 @@
+#include <cstdlib>
+#include <iostream>
+#include "linear_algebra.hh"
+#include "parallel.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Construct the matrix and vectors in the current construction mode and measure the
+// bandwidth of the parallel kernels in GB/s
+void benchmark(std::size_t m, std::size_t n, int repeat)
+{
+  Timer t;
+  DenseMatrix A(m, m, 1.0);
+  DenseVector u(m, 1.0), v(m);
+  DenseVector x(n, 1.0), y(n, 2.0);
+  std::cout << "  construction: " << (t.elapsed()*1000.0) << " ms\n";
+
+  t.reset();
+  for (int i = 0; i < repeat; ++i)
+    A.mult(u, v);
+  std::cout << "  mult:         " << (1.0*m*m*sizeof(double)*repeat/t.elapsed()/1.e9) << " GB/s\n";
+
+  t.reset();
+  for (int i = 0; i < repeat; ++i)
+    y.axpy(1.e-8, x);
+  std::cout << "  axpy:         " << (3.0*n*sizeof(double)*repeat/t.elapsed()/1.e9) << " GB/s\n";
+
+  t.reset();
+  for (int i = 0; i < repeat; ++i)
+    x.dot(y);
+  std::cout << "  dot:          " << (2.0*n*sizeof(double)*repeat/t.elapsed()/1.e9) << " GB/s\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t m = argc > 1 ? std::atol(argv[1]) : 8192;
+  std::size_t n = argc > 2 ? std::atol(argv[2]) : (std::size_t(1) << 25);
+  int repeat = 10;
+
+  std::cout << "matrix " << m << "x" << m << ", vectors of size " << n
+            << ", threads " << parallel::num_threads() << "\n";
+
+  // before: all pages are touched by the main thread, i.e., placed on its NUMA node
+  parallel::set_first_touch(false);
+  std::cout << "sequential construction:\n";
+  benchmark(m, n, repeat);
+
+  // after: pages are touched by the threads that work on them in the kernels
+  parallel::set_first_touch(true);
+  std::cout << "parallel first-touch construction:\n";
+  benchmark(m, n, repeat);
+}
+
+// Run with pinned threads to see the effect on multi-socket machines, e.g.,
+//   OMP_PROC_BIND=spread OMP_PLACES=cores ./benchmark_first_touch
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -fopenmp linear_algebra.cc benchmark_first_touch.cc -o benchmark_first_touch
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include "linear_algebra.hh"
+#include "parallel.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Naive triple loop C = A*B, used to check the result for small sizes
+DenseMatrix mult_reference(DenseMatrix const& A, DenseMatrix const& B)
+{
+  DenseMatrix C(A.rows(), B.cols(), 0.0);
+  for (std::size_t i = 0; i < A.rows(); ++i)
+    for (std::size_t k = 0; k < A.cols(); ++k)
+      for (std::size_t j = 0; j < B.cols(); ++j)
+        C(i,j) += A(i,k) * B(k,j);
+  return C;
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n_max = argc > 1 ? std::atoi(argv[1]) : 2048;
+  double ghz = argc > 2 ? std::atof(argv[2]) : 3.0;
+
+  // theoretical peak: clock * (2 FMA units * flops per FMA instruction) * threads, for the
+  // instruction set of the gemm micro-kernel
+  std::string isa = gemm_instruction_set();
+  double flops_per_cycle = isa == "avx2" ? 16 : 4;
+  double peak = ghz * flops_per_cycle * parallel::num_threads();
+  std::cout << "instruction set: " << isa << ", threads: " << parallel::num_threads()
+            << ", assumed peak: " << peak << " GFLOP/s (" << ghz << " GHz)\n";
+
+  for (std::size_t n = 256; n <= n_max; n *= 2) {
+    DenseMatrix A(n, n), B(n, n), C(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = 0; j < n; ++j) {
+        A(i,j) = 1.0 / (i + j + 1.0);
+        B(i,j) = double(i) - double(j);
+      }
+    }
+
+    Timer t;
+    gemm(1.0, A, B, 0.0, C);
+    double time = t.elapsed();
+    double gflops = 2.0 * n * n * n / time / 1.e9;
+
+    std::cout << "n = " << n << ": " << (time*1000.0) << " ms, " << gflops << " GFLOP/s, "
+              << (100.0 * gflops / peak) << " % of peak";
+    if (n <= 512) {
+      DenseMatrix D = mult_reference(A, B);
+      D -= C;
+      double err = 0;
+      for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+          err = std::max(err, std::abs(D(i,j)));
+      std::cout << ", max error " << err;
+    }
+    std::cout << "\n";
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -fopenmp linear_algebra.cc benchmark_gemm.cc -o benchmark_gemm
+// and run with the maximal size and the clock frequency in GHz, e.g. ./benchmark_gemm 8192 2.5
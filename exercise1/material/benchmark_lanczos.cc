@@ -0,0 +1,84 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include "linear_algebra.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Power method for the largest eigenvalue, the approach of exercise2/solution/task4.cc
+double power_method(LaplacianOperator const& A, DenseVector v, int k)
+{
+  DenseVector w(v.size());
+  double lambda = 0.0;
+  v *= 1.0 / v.two_norm();
+  for (int i = 0; i < k; ++i) {
+    A.mult(v, w);
+    lambda = w.dot(v);
+    v = (1.0 / w.two_norm()) * w;
+  }
+  return lambda;
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 512;
+  LaplacianOperator A(n, n);
+
+  // eigenvalues of the five-point-stencil: 4 - 2cos(i pi h) - 2cos(j pi h), h = 1/(n+1)
+  double c = std::cos(M_PI / (n + 1));
+  double lmin = 4.0 - 4.0*c, lmax = 4.0 + 4.0*c;
+  std::cout << "grid " << n << "x" << n << ": lambda_min " << lmin << ", lambda_max " << lmax
+            << ", condition " << (lmax / lmin) << "\n";
+
+  // a start vector with components in all eigenvectors
+  DenseVector v0(n*n);
+  for (std::size_t i = 0; i < n*n; ++i)
+    v0[i] = std::sin(1.0 + 7.0*i) + 0.5;
+
+  auto print = [&](LanczosTridiagonal const& T) {
+    std::cout << "min " << T.min_eigenvalue() << " (error " << std::abs(T.min_eigenvalue() - lmin) / lmin
+              << "), max " << T.max_eigenvalue() << " (error " << std::abs(T.max_eigenvalue() - lmax) / lmax
+              << ")";
+  };
+
+  std::cout << "lanczos:\n";
+  for (std::size_t k : {10, 20, 50, 100, 200}) {
+    LanczosTridiagonal T;
+    Timer t;
+    lanczos(A, v0, k, T);
+    double time = t.elapsed();
+    std::cout << "  " << k << " steps: ";
+    print(T);
+    std::cout << ", " << (time*1000.0) << " ms\n";
+  }
+
+  std::cout << "power method:\n";
+  for (int k : {10, 100, 1000}) {
+    Timer t;
+    double lambda = power_method(A, v0, k);
+    double time = t.elapsed();
+    std::cout << "  " << k << " steps: max " << lambda << " (error " << std::abs(lambda - lmax) / lmax
+              << "), " << (time*1000.0) << " ms\n";
+  }
+
+  // the same estimates from the coefficients of a cg solve, without extra operator applications
+  std::cout << "cg coefficients:\n";
+  DenseVector b(n*n, 1.0);
+  for (double rtol : {1.e-2, 1.e-4, 1.e-8}) {
+    DenseVector x(n*n, 0.0);
+    BasicIteration iter(b, 10000, rtol);
+    iter.set_quite(true);
+    iter.suppress_resume(true);
+    LanczosTridiagonal T;
+    Timer t;
+    cg(A, x, b, iter, &T);
+    double time = t.elapsed();
+    std::cout << "  rtol " << rtol << ", " << iter.iterations() << " iterations: ";
+    print(T);
+    std::cout << ", solve " << (time*1000.0) << " ms\n";
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG linear_algebra.cc benchmark_lanczos.cc -o benchmark_lanczos
@@ -0,0 +1,62 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "linear_algebra.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Assemble the Laplacian on an n x n grid and measure setup time, memory and mat-vec time
+template <class Matrix>
+void benchmark(std::string const& name, std::size_t n, std::size_t bytes, int repeat = 10)
+{
+  Timer t;
+  Matrix A;
+  laplacian_setup(A, n, n);
+  double setup = t.elapsed();
+
+  DenseVector x(n*n, 1.0), y(n*n);
+  t.reset();
+  for (int i = 0; i < repeat; ++i)
+    A.mult(x, y);
+  double mult = t.elapsed() / repeat;
+
+  std::cout << "  " << name << ": setup " << (setup*1000.0) << " ms, "
+            << "mat-vec " << (mult*1000.0) << " ms, "
+            << "memory " << (bytes / (1024.0*1024.0)) << " MB\n";
+}
+
+// Apply the matrix-free stencil operator, no setup and no matrix storage needed
+void benchmark_matrix_free(std::size_t n, int repeat = 10)
+{
+  LaplacianOperator A(n, n);
+
+  DenseVector x(n*n, 1.0), y(n*n);
+  Timer t;
+  for (int i = 0; i < repeat; ++i)
+    A.mult(x, y);
+  double mult = t.elapsed() / repeat;
+
+  std::cout << "  LaplacianOperator: mat-vec " << (mult*1000.0) << " ms, memory 0 MB\n";
+}
+
+int main(int argc, char** argv)
+{
+  // grid sizes above dense_max are only run with the sparse matrix
+  std::size_t n_max = argc > 1 ? std::atoi(argv[1]) : 512;
+  std::size_t dense_max = argc > 2 ? std::atoi(argv[2]) : 64;
+
+  for (std::size_t n = 8; n <= n_max; n *= 2) {
+    std::size_t N = n*n;
+    std::cout << "grid " << n << "x" << n << " (" << N << " unknowns):\n";
+    if (n <= dense_max)
+      benchmark<DenseMatrix>("DenseMatrix", n, N*N*sizeof(double));
+
+    std::size_t nnz = 5*N - 4*n;
+    benchmark<CRSMatrix>("CRSMatrix  ", n, nnz*(sizeof(double) + sizeof(std::size_t)) + (N+1)*sizeof(std::size_t));
+    benchmark_matrix_free(n);
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O2 linear_algebra.cc benchmark_laplacian.cc -o benchmark_laplacian
@@ -0,0 +1,87 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "linear_algebra.hh"
+#include "lu.hh"
+#include "mixed_precision.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Print the time to reach the tolerance, the number of iterations and the final relative residual
+void report(std::string const& name, double time, int iterations,
+            DenseMatrix const& A, DenseVector const& x, DenseVector const& b)
+{
+  DenseVector r(b.size());
+  A.mult(x, r);
+  r.aypx(-1.0, b);
+  std::cout << "  " << name << ": " << (time*1000.0) << " ms, "
+            << iterations << " iterations, relative residual "
+            << (r.two_norm() / b.two_norm()) << "\n";
+}
+
+BasicIteration make_iteration(DenseVector const& b, int max_iter, double rtol)
+{
+  BasicIteration iter(b, max_iter, rtol);
+  iter.set_quite(true);
+  iter.suppress_resume(true);
+  return iter;
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t m_max = argc > 1 ? std::atoi(argv[1]) : 48;
+  double rtol = argc > 2 ? std::atof(argv[2]) : 1.e-10;
+
+  for (std::size_t m = 16; m <= m_max; m += 16) {
+    DenseMatrix A;
+    laplacian_setup(A, m, m);
+    std::size_t N = A.rows();
+    DenseVector b(N, 1.0);
+
+    std::cout << "dense Laplacian " << N << "x" << N << ", rtol " << rtol << ":\n";
+
+    // direct solver: double LU vs. float LU with refinement in double
+    {
+      DenseVector x(N);
+      Timer t;
+      LU lu;
+      lu.compute(A);
+      lu.apply(b, x);
+      report("LU<double>             ", t.elapsed(), 1, A, x, b);
+    }
+    {
+      DenseVector x(N);
+      auto iter = make_iteration(b, 100, rtol);
+      Timer t;
+      BasicDenseMatrix<float> A_low;
+      convert(A, A_low);
+      BasicLU<float> lu;
+      lu.compute(A_low);
+      iterative_refinement(A, x, b, lu, iter);
+      report("LU<float> + refinement ", t.elapsed(), iter.iterations(), A, x, b);
+    }
+
+    // iterative solver: double cg vs. float cg with refinement in double
+    {
+      DenseVector x(N);
+      auto iter = make_iteration(b, 100000, rtol);
+      Timer t;
+      cg(A, x, b, iter);
+      report("cg<double>             ", t.elapsed(), iter.iterations(), A, x, b);
+    }
+    {
+      DenseVector x(N);
+      auto iter = make_iteration(b, 100, rtol);
+      Timer t;
+      BasicDenseMatrix<float> A_low;
+      convert(A, A_low);
+      CGInnerSolver<BasicDenseMatrix<float>> inner(A_low, 1.e-4);
+      iterative_refinement(A, x, b, inner, iter);
+      report("cg<float> + refinement ", t.elapsed(), iter.iterations(), A, x, b);
+    }
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG linear_algebra.cc lu.cc benchmark_mixed.cc -o benchmark_mixed
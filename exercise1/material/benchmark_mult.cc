@@ -0,0 +1,56 @@
+#include <cstdlib>
+#include <iostream>
+#include "linear_algebra.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// The plain row loop, accumulating into y[r], used as reference
+void mult_reference(DenseMatrix const& A, DenseVector const& x, DenseVector& y)
+{
+  for (std::size_t r = 0; r < A.rows(); ++r) {
+    y[r] = 0.0;
+    double const* row = A[r];
+    for (std::size_t c = 0; c < A.cols(); ++c)
+      y[r] += row[c]*x[c];
+  }
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n_max = argc > 1 ? std::atoi(argv[1]) : 4096;
+
+  std::cout << "instruction set: " << simd_instruction_set() << "\n";
+  for (std::size_t n = 64; n <= n_max; n *= 2) {
+    DenseMatrix A(n, n);
+    DenseVector x(n), y(n), y_ref(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = 1.0 / (i + 1.0);
+      for (std::size_t j = 0; j < n; ++j)
+        A(i,j) = double(i + 2*j) / n;
+    }
+
+    // repeat such that roughly 2^30 flops are performed per measurement
+    int repeat = int(std::max<std::size_t>(1, (std::size_t(1) << 29) / (n*n)));
+    double flops = 2.0 * n * n * repeat;
+
+    Timer t;
+    for (int i = 0; i < repeat; ++i)
+      mult_reference(A, x, y_ref);
+    double t_ref = t.elapsed();
+
+    t.reset();
+    for (int i = 0; i < repeat; ++i)
+      A.mult(x, y);
+    double t_simd = t.elapsed();
+
+    y -= y_ref;
+    std::cout << "n = " << n << ":\n"
+              << "  reference: " << (flops/t_ref/1.e9)  << " GFLOP/s\n"
+              << "  mult:      " << (flops/t_simd/1.e9) << " GFLOP/s\n"
+              << "  |y - y_ref|_inf / |y_ref|_inf = " << (y.inf_norm() / y_ref.inf_norm()) << "\n";
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG linear_algebra.cc benchmark_mult.cc -o benchmark_mult
@@ -0,0 +1,49 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "linear_algebra.hh"
+#include "multigrid.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Report iterations and time of a solver run to the given tolerance
+template <class Solver>
+void benchmark(std::string const& name, std::size_t N, double rtol, Solver solver)
+{
+  DenseVector b(N, 1.0), x(N);
+  BasicIteration iter(b, 10000, rtol);
+  iter.set_quite(true);
+  iter.suppress_resume(true);
+
+  Timer t;
+  int err = solver(x, b, iter);
+  double time = t.elapsed();
+
+  std::cout << "  " << name << ": " << iter.iterations() << " iterations, "
+            << (time*1000.0) << " ms" << (err ? " (not converged)" : "") << "\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n_max = argc > 1 ? std::atoi(argv[1]) : 511;
+  double rtol = argc > 2 ? std::atof(argv[2]) : 1.e-8;
+
+  for (std::size_t n = 31; n <= n_max; n = 2*n+1) {
+    std::cout << "grid " << n << "x" << n << ", rtol " << rtol << ":\n";
+    LaplacianOperator A(n, n);
+
+    Timer t;
+    GeometricMultigrid V(n, n, 1);
+    GeometricMultigrid W(n, n, 2);
+    std::cout << "  setup: " << (t.elapsed()*1000.0/2) << " ms, " << V.levels() << " levels\n";
+
+    benchmark("CG        ", n*n, rtol, [&](auto& x, auto const& b, auto& iter) { return cg(A, x, b, iter); });
+    benchmark("V-cycle   ", n*n, rtol, [&](auto& x, auto const& b, auto& iter) { return multigrid(V, x, b, iter); });
+    benchmark("W-cycle   ", n*n, rtol, [&](auto& x, auto const& b, auto& iter) { return multigrid(W, x, b, iter); });
+    benchmark("PCG(V)    ", n*n, rtol, [&](auto& x, auto const& b, auto& iter) { return pcg(A, x, b, V, iter); });
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG linear_algebra.cc lu.cc multigrid.cc benchmark_multigrid.cc -o benchmark_multigrid
@@ -0,0 +1,61 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "linear_algebra.hh"
+#include "stencil.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Solve with the given solver and print iterations, operator applications, time and the
+// true final residual
+template <class Solver>
+void run(std::string const& name, CRSMatrix const& A, DenseVector const& b,
+         int mults_per_iteration, Solver solver)
+{
+  DenseVector x(b.size(), 0.0);
+  BasicIteration iter(b, 5000, 1.e-8);
+  iter.set_quite(true);
+  iter.suppress_resume(true);
+
+  Timer t;
+  int err = solver(x, iter);
+  double time = t.elapsed();
+
+  DenseVector r(b.size());
+  A.mult(x, r);
+  r.aypx(-1.0, b);
+  std::cout << "    " << name << ": " << iter.iterations() << " iterations, "
+            << (mults_per_iteration * iter.iterations()) << " mat-vecs, "
+            << (time*1000.0) << " ms, true residual " << (r.two_norm() / b.two_norm())
+            << (err ? ", error " + std::to_string(err) : std::string()) << "\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 256;
+  DenseVector b(n*n, 1.0);
+
+  // convection in direction (1, 0.5), from diffusion-dominated to convection-dominated
+  for (double v : {0.0, 0.5, 1.0, 1.9}) {
+    CRSMatrix A;
+    stencil_setup(A, convection_diffusion_stencil(v, 0.5*v), n, n);
+    std::cout << "grid " << n << "x" << n << ", velocity*h = (" << v << ", " << 0.5*v << "):\n";
+
+    run("cg        ", A, b, 1, [&](DenseVector& x, BasicIteration& iter) {
+      return cg(A, x, b, iter);
+    });
+    run("bicgstab  ", A, b, 2, [&](DenseVector& x, BasicIteration& iter) {
+      return bicgstab(A, x, b, iter);
+    });
+    for (std::size_t m : {10, 30, 100}) {
+      run("gmres(" + std::to_string(m) + ")" + std::string(m < 100 ? 2 : 1, ' '), A, b, 1,
+        [&](DenseVector& x, BasicIteration& iter) {
+          return gmres(A, x, b, iter, m);
+        });
+    }
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -fopenmp linear_algebra.cc benchmark_nonsymmetric.cc -o benchmark_nonsymmetric
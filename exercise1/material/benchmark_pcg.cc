@@ -0,0 +1,58 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "linear_algebra.hh"
+#include "preconditioner.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Identity preconditioner, z = r, to run pcg without preconditioning
+struct IdentityPreconditioner
+{
+  void compute(CRSMatrix const&) {}
+  void apply(DenseVector const& r, DenseVector& z) const { z = r; }
+};
+
+// Solve the Laplacian system to the given tolerance and report setup time, iterations and solve time
+template <class Preconditioner>
+void benchmark(std::string const& name, CRSMatrix const& A, Preconditioner P, double rtol)
+{
+  DenseVector b(A.rows(), 1.0), x(A.rows());
+  BasicIteration iter(b, 100000, rtol);
+  iter.set_quite(true);
+  iter.suppress_resume(true);
+
+  Timer t;
+  P.compute(A);
+  double setup = t.elapsed();
+
+  t.reset();
+  int err = pcg(A, x, b, P, iter);
+  double solve = t.elapsed();
+
+  std::cout << "  " << name << ": " << iter.iterations() << " iterations, "
+            << "setup " << (setup*1000.0) << " ms, solve " << (solve*1000.0) << " ms"
+            << (err ? " (not converged)" : "") << "\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n_max = argc > 1 ? std::atoi(argv[1]) : 512;
+  double rtol = argc > 2 ? std::atof(argv[2]) : 1.e-8;
+
+  for (std::size_t n = 32; n <= n_max; n *= 2) {
+    CRSMatrix A;
+    laplacian_setup(A, n, n);
+
+    std::cout << "grid " << n << "x" << n << ", rtol " << rtol << ":\n";
+    benchmark("none       ", A, IdentityPreconditioner{}, rtol);
+    benchmark("Jacobi     ", A, JacobiPreconditioner{}, rtol);
+    benchmark("SGS        ", A, SSORPreconditioner{1.0}, rtol);
+    benchmark("SSOR(1.5)  ", A, SSORPreconditioner{1.5}, rtol);
+    benchmark("IC(0)      ", A, IC0Preconditioner{}, rtol);
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG linear_algebra.cc preconditioner.cc benchmark_pcg.cc -o benchmark_pcg
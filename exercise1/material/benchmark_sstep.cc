@@ -0,0 +1,65 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "linear_algebra.hh"
+#include "parallel.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Print the time per iteration, the number of global reductions and the true final residual
+template <class Solver>
+void run(std::string const& name, LaplacianOperator const& A, DenseVector const& b,
+         double reductions, Solver solver)
+{
+  DenseVector x(b.size(), 0.0);
+  BasicIteration iter(b, 10000, 1.e-8);
+  iter.set_quite(true);
+  iter.suppress_resume(true);
+
+  Timer t;
+  solver(x, iter);
+  double time = t.elapsed();
+
+  DenseVector r(b.size());
+  A.mult(x, r);
+  r.aypx(-1.0, b);
+  std::cout << "    " << name << ": " << iter.iterations() << " iterations, "
+            << (time*1000.0) << " ms, " << (time*1.e6 / iter.iterations()) << " us/iteration, "
+            << reductions << " reductions/iteration, "
+            << "true residual " << (r.two_norm() / b.two_norm()) << "\n";
+}
+
+int main(int argc, char** argv)
+{
+  int max_threads = argc > 1 ? std::atoi(argv[1]) : int(std::thread::hardware_concurrency());
+
+  // small grids are dominated by the synchronization, large grids by memory bandwidth
+  for (std::size_t n : {64, 256, 512}) {
+    LaplacianOperator A(n, n);
+    DenseVector b(n*n, 1.0);
+
+    // eigenvalues of the five-point-stencil: 4 - 2cos(i pi h) - 2cos(j pi h), h = 1/(n+1)
+    double c = std::cos(M_PI / (n + 1));
+    double lmin = 4.0 - 4.0*c, lmax = 4.0 + 4.0*c;
+
+    std::cout << "grid " << n << "x" << n << ":\n";
+    for (int t = 1; t <= max_threads; t *= 2) {
+      parallel::set_num_threads(t);
+      std::cout << "  threads " << t << ":\n";
+      run("cg        ", A, b, 2.0, [&](DenseVector& x, BasicIteration& iter) {
+        cg(A, x, b, iter);
+      });
+      for (std::size_t s : {2, 4, 8}) {
+        run("cg_sstep(" + std::to_string(s) + ")", A, b, 1.0/s, [&](DenseVector& x, BasicIteration& iter) {
+          cg_sstep(A, x, b, iter, s, lmin, lmax);
+        });
+      }
+    }
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -fopenmp linear_algebra.cc benchmark_sstep.cc -o benchmark_sstep
@@ -0,0 +1,123 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "linear_algebra.hh"
+#include "parallel.hh"
+#include "stencil.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Reference assembly of the previous laplacian_setup: one row after the other, growing
+// the compressed arrays with push_back
+void push_back_setup(CRSMatrix& A, Stencil const& s, std::size_t m, std::size_t n,
+                     std::size_t l)
+{
+  using size_type = CRSMatrix::size_type;
+  std::vector<size_type> offsets(m*n*l + 1, 0);
+  std::vector<size_type> indices;
+  std::vector<double> values;
+
+  for (std::size_t i = 0; i < m; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      for (std::size_t k = 0; k < l; ++k) {
+        std::size_t row = (i*n + j)*l + k;
+        for (std::size_t e = 0; e < s.size(); ++e) {
+          std::ptrdiff_t ii = i + s[e].di, jj = j + s[e].dj, kk = k + s[e].dk;
+          if (ii >= 0 && ii < std::ptrdiff_t(m) && jj >= 0 && jj < std::ptrdiff_t(n) &&
+              kk >= 0 && kk < std::ptrdiff_t(l)) {
+            indices.push_back((ii*n + jj)*l + kk);
+            values.push_back(s[e].weight);
+          }
+        }
+        offsets[row+1] = indices.size();
+      }
+    }
+  }
+
+  A = CRSMatrix(m*n*l, m*n*l,
+                CRSMatrix::index_array(offsets.begin(), offsets.end()),
+                CRSMatrix::index_array(indices.begin(), indices.end()),
+                CRSMatrix::value_array(values.begin(), values.end()));
+}
+
+// Return the maximal difference of the entries of two sparse matrices with the same pattern
+double difference(CRSMatrix const& A, CRSMatrix const& B)
+{
+  if (A.indices() != B.indices() || A.offsets() != B.offsets())
+    return INFINITY;
+  double d = 0.0;
+  for (std::size_t i = 0; i < A.values().size(); ++i)
+    d = std::max(d, std::abs(A.values()[i] - B.values()[i]));
+  return d;
+}
+
+// Measure the best time out of `repeat` calls of setup(A) and print the rows per second
+template <class Setup>
+double measure(std::string const& name, std::size_t rows, CRSMatrix& A, Setup setup,
+               int repeat = 5)
+{
+  double best = INFINITY;
+  for (int i = 0; i < repeat; ++i) {
+    Timer t;
+    setup(A);
+    best = std::min(best, t.elapsed());
+  }
+  std::cout << "  " << name << ": " << (best*1000.0) << " ms, "
+            << (rows / best / 1.0e6) << " Mrows/s\n";
+  return best;
+}
+
+// Compare the parallel stencil assembly with the push_back reference
+void benchmark(std::string const& name, Stencil const& s, std::size_t m, std::size_t n,
+               std::size_t l)
+{
+  std::size_t rows = m*n*l;
+  std::cout << name << " (" << rows << " rows):\n";
+  CRSMatrix A, B;
+  double t_ref = measure("push_back    ", rows, B, [&](CRSMatrix& M) { push_back_setup(M, s, m, n, l); });
+  double t_par = measure("stencil_setup", rows, A, [&](CRSMatrix& M) { stencil_setup(M, s, m, n, l); });
+  std::cout << "  speedup " << (t_ref / t_par) << ", difference " << difference(A, B) << "\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 2048;
+  std::size_t n3 = argc > 2 ? std::atoi(argv[2]) : 160;
+
+  std::cout << "threads: " << parallel::num_threads() << "\n";
+  benchmark("five-point 2D", five_point_stencil(), n, n, 1);
+  benchmark("nine-point 2D", nine_point_stencil(), n, n, 1);
+  benchmark("seven-point 3D", seven_point_stencil(), n3, n3, n3);
+
+  // diffusion -div(a grad u) with a smoothly varying coefficient a(x,y,z), evaluated at the
+  // midpoints between the grid points of the seven-point-stencil
+  Stencil const s = seven_point_stencil();
+  double const h = 1.0 / (n3 + 1);
+  auto a = [](double x, double y, double z) {
+    return 1.0 + 0.5*std::sin(6.0*x)*std::cos(4.0*y)*std::exp(z);
+  };
+  auto weight = [&](std::size_t i, std::size_t j, std::size_t k, std::size_t e) {
+    double x = (i + 1)*h, y = (j + 1)*h, z = (k + 1)*h;
+    if (s[e].di == 0 && s[e].dj == 0 && s[e].dk == 0)
+      return a(x - 0.5*h, y, z) + a(x + 0.5*h, y, z) + a(x, y - 0.5*h, z)
+           + a(x, y + 0.5*h, z) + a(x, y, z - 0.5*h) + a(x, y, z + 0.5*h);
+    return -a(x + 0.5*h*s[e].di, y + 0.5*h*s[e].dj, z + 0.5*h*s[e].dk);
+  };
+  std::size_t rows = n3*n3*n3;
+  std::cout << "variable diffusion 3D (" << rows << " rows):\n";
+  CRSMatrix A;
+  measure("stencil_setup", rows, A, [&](CRSMatrix& M) { stencil_setup(M, s, n3, n3, n3, weight); });
+
+  // the operator is symmetric up to rounding, both rows of a face evaluate the same coefficient
+  double asym = 0.0;
+  for (std::size_t r = 0; r < rows; r += 997)
+    for (std::size_t p = A.offsets()[r]; p < A.offsets()[r+1]; ++p)
+      asym = std::max(asym, std::abs(A.values()[p] - A(A.indices()[p], r)));
+  std::cout << "  asymmetry " << asym << "\n";
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -fopenmp linear_algebra.cc benchmark_stencil.cc -o benchmark_stencil
@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "linear_algebra.hh"
+#include "parallel.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// STREAM triad a = b + s*c on plain std::vector storage, as the reference bandwidth
+double stream_triad(std::size_t n, int repeat)
+{
+  std::vector<double> a(n, 0.0), b(n, 1.0), c(n, 2.0);
+  double* ap = a.data();
+  double const* bp = b.data();
+  double const* cp = c.data();
+  Timer t;
+  for (int i = 0; i < repeat; ++i) {
+    parallel::for_each_block(n, [=](std::size_t first, std::size_t last) {
+      for (std::size_t j = first; j < last; ++j)
+        ap[j] = bp[j] + 3.0 * cp[j];
+    });
+  }
+  return 3.0 * n * sizeof(double) * repeat / t.elapsed() / 1.e9;
+}
+
+// Measure the bandwidth of the vector kernels and of the dense matrix-vector product in GB/s
+void benchmark(std::size_t n, std::size_t m, int repeat)
+{
+  Timer t;
+  DenseVector x(n, 1.0), y(n, 2.0);
+  DenseMatrix A(m, m, 1.0);
+  DenseVector u(m, 1.0), v(m);
+  double t_init = t.elapsed();
+
+  std::cout << "  init:     " << (t_init*1000.0) << " ms, data aligned to 64 bytes: "
+            << (reinterpret_cast<std::uintptr_t>(x.data()) % cache_line_size == 0 &&
+                reinterpret_cast<std::uintptr_t>(A[0]) % cache_line_size == 0) << "\n";
+
+  t.reset();
+  for (int i = 0; i < repeat; ++i)
+    y *= 1.0;
+  std::cout << "  scale:    " << (2.0*n*sizeof(double)*repeat/t.elapsed()/1.e9) << " GB/s\n";
+
+  t.reset();
+  for (int i = 0; i < repeat; ++i)
+    y.axpy(1.e-8, x);
+  std::cout << "  axpy:     " << (3.0*n*sizeof(double)*repeat/t.elapsed()/1.e9) << " GB/s\n";
+
+  t.reset();
+  for (int i = 0; i < repeat; ++i)
+    x.dot(y);
+  std::cout << "  dot:      " << (2.0*n*sizeof(double)*repeat/t.elapsed()/1.e9) << " GB/s\n";
+
+  t.reset();
+  for (int i = 0; i < repeat; ++i)
+    A.mult(u, v);
+  std::cout << "  mult:     " << (1.0*m*m*sizeof(double)*repeat/t.elapsed()/1.e9) << " GB/s\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n = argc > 1 ? std::atol(argv[1]) : (std::size_t(1) << 25);
+  std::size_t m = argc > 2 ? std::atol(argv[2]) : 8192;
+  int repeat = 10;
+
+  std::cout << "vectors of size " << n << ", matrix " << m << "x" << m
+            << ", threads " << parallel::num_threads() << "\n";
+  std::cout << "stream triad (std::vector): " << stream_triad(n, repeat) << " GB/s\n";
+
+  for (bool huge : {false, true}) {
+    set_huge_pages(huge);
+    std::cout << "transparent huge pages " << (huge ? "on" : "off") << ":\n";
+    benchmark(n, m, repeat);
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -fopenmp linear_algebra.cc benchmark_stream.cc -o benchmark_stream
@@ -0,0 +1,63 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "linear_algebra.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Solve the Laplacian system with cg and return the solve time
+double solve(CRSMatrix const& A, BasicIteration& iter)
+{
+  DenseVector b(A.rows(), 1.0), x(A.rows());
+  Timer t;
+  cg(A, x, b, iter);
+  return t.elapsed();
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 256;
+  std::string csv = argc > 2 ? argv[2] : "";
+
+  CRSMatrix A;
+  laplacian_setup(A, n, n);
+  DenseVector b(A.rows(), 1.0);
+
+  // 1. print the residual in each iteration
+  BasicIteration iter1(b, 10000, 1.e-8, 0, 1);
+  iter1.suppress_resume(true);
+  double t_print = solve(A, iter1);
+
+  // 2. no output at all
+  BasicIteration iter2(b, 10000, 1.e-8);
+  iter2.set_quite(true);
+  iter2.suppress_resume(true);
+  double t_quiet = solve(A, iter2);
+
+  // 3. record the residual history, export after the solve
+  IterationTelemetry telemetry(100000);
+  BasicIteration iter3(b, 10000, 1.e-8);
+  iter3.set_quite(true);
+  iter3.suppress_resume(true);
+  iter3.set_telemetry(&telemetry);
+  double t_telemetry = solve(A, iter3);
+
+  Timer t;
+  if (!csv.empty()) {
+    std::ofstream out(csv);
+    telemetry.write_csv(out);
+  }
+  double t_export = t.elapsed();
+
+  std::cerr << "grid " << n << "x" << n << ", " << iter2.iterations() << " iterations:\n"
+            << "  print each iteration: " << (t_print*1000.0) << " ms\n"
+            << "  quiet:                " << (t_quiet*1000.0) << " ms\n"
+            << "  telemetry:            " << (t_telemetry*1000.0) << " ms, "
+            << telemetry.size() << " records, export " << (t_export*1000.0) << " ms\n";
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG linear_algebra.cc benchmark_telemetry.cc -o benchmark_telemetry
+// and run with the residual printouts redirected, e.g. ./benchmark_telemetry 256 history.csv > log.txt
@@ -0,0 +1,71 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "linear_algebra.hh"
+#include "parallel.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+int main(int argc, char** argv)
+{
+  std::size_t n = argc > 1 ? std::atol(argv[1]) : (1u << 24);
+  int max_threads = argc > 2 ? std::atoi(argv[2]) : int(std::thread::hardware_concurrency());
+  int repeat = 10;
+
+  DenseVector x(n), y(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] = 1.0 / (i + 1.0);
+    y[i] = std::sin(double(i));
+  }
+  DenseVector const y0(y);
+
+  // bytes transferred by kernels reading one or two vectors and by kernels updating a vector
+  double bytes1 = n * sizeof(double), bytes2 = 2 * bytes1, bytes3 = 3 * bytes1;
+
+  double dot_ref = 0, norm_ref = 0;
+  for (int t = 1; t <= max_threads; t *= 2) {
+    parallel::set_num_threads(t);
+
+    Timer timer;
+    double dot = 0;
+    for (int i = 0; i < repeat; ++i)
+      dot = x.dot(y);
+    double t_dot = timer.elapsed() / repeat;
+
+    timer.reset();
+    double norm = 0;
+    for (int i = 0; i < repeat; ++i)
+      norm = y.two_norm();
+    double t_norm = timer.elapsed() / repeat;
+
+    timer.reset();
+    for (int i = 0; i < repeat; ++i)
+      y.axpy(1.e-8, x);
+    double t_axpy = timer.elapsed() / repeat;
+
+    timer.reset();
+    for (int i = 0; i < repeat; ++i)
+      y.aypx(1.0, x);
+    double t_aypx = timer.elapsed() / repeat;
+
+    // restore the data so that all thread counts see the same input
+    y = y0;
+
+    if (t == 1) {
+      dot_ref = dot;
+      norm_ref = norm;
+    }
+
+    std::cout << "threads " << t << ":\n"
+              << "  dot:      " << (bytes2/t_dot/1.e9)  << " GB/s\n"
+              << "  two_norm: " << (bytes1/t_norm/1.e9) << " GB/s\n"
+              << "  axpy:     " << (bytes3/t_axpy/1.e9) << " GB/s\n"
+              << "  aypx:     " << (bytes3/t_aypx/1.e9) << " GB/s\n"
+              << "  bitwise reproducible: " << (dot == dot_ref && norm == norm_ref) << "\n";
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -fopenmp linear_algebra.cc benchmark_threads.cc -o benchmark_threads
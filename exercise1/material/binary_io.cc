@@ -0,0 +1,222 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "binary_io.hh"
+#include "parallel.hh"
+
+namespace scprog {
+
+namespace {
+
+constexpr char binary_magic[8] = {'S','C','P','R','O','G','D','M'};
+constexpr std::uint32_t binary_byte_order = 0x01020304;
+constexpr std::uint32_t binary_kind_vector = 1;
+constexpr std::uint32_t binary_kind_matrix = 2;
+
+// Write the header and the contiguous entries of a vector or matrix to a file
+template <class T>
+void write_payload(std::string const& filename, std::uint32_t kind, std::size_t rows,
+                   std::size_t cols, T const* data)
+{
+  BinaryHeader header = {};
+  std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+  header.version = binary_format_version;
+  header.kind = kind;
+  header.value_size = sizeof(T);
+  header.byte_order = binary_byte_order;
+  header.rows = rows;
+  header.cols = cols;
+  header.payload_offset = sizeof(BinaryHeader);
+
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  out.write(reinterpret_cast<char const*>(data), std::streamsize(rows * cols * sizeof(T)));
+  if (!out)
+    throw std::runtime_error("Cannot write binary file '" + filename + "'");
+}
+
+// Validate the header of a mapped file and return a pointer to the first entry
+template <class T>
+T const* read_payload(MappedFile const& file, std::string const& filename, std::uint32_t kind,
+                      std::size_t& rows, std::size_t& cols)
+{
+  auto fail = [&](std::string const& reason) {
+    throw std::runtime_error("Invalid binary file '" + filename + "': " + reason);
+  };
+
+  if (file.size() < sizeof(BinaryHeader))
+    fail("file too small for the header");
+
+  BinaryHeader header;
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0)
+    fail("wrong magic number");
+  if (header.version == 0 || header.version > binary_format_version)
+    fail("unsupported format version " + std::to_string(header.version));
+  if (header.byte_order != binary_byte_order)
+    fail("different byte order");
+  if (header.kind != kind)
+    fail(kind == binary_kind_vector ? "does not contain a vector" : "does not contain a matrix");
+  if (header.value_size != sizeof(T))
+    fail("entries of size " + std::to_string(header.value_size) + " bytes, expected "
+         + std::to_string(sizeof(T)));
+  if (header.kind == binary_kind_vector && header.cols != 1)
+    fail("vector with " + std::to_string(header.cols) + " columns");
+
+  // the header fields are untrusted, so the sizes are compared without overflow
+  if (header.payload_offset < sizeof(BinaryHeader) || header.payload_offset > file.size() ||
+      header.payload_offset % alignof(T) != 0)
+    fail("invalid payload offset");
+  if (header.rows != 0 &&
+      header.cols > (file.size() - header.payload_offset) / sizeof(T) / header.rows)
+    fail("payload does not fit into the file");
+
+  rows = header.rows;
+  cols = header.cols;
+  return reinterpret_cast<T const*>(file.data() + header.payload_offset);
+}
+
+} // end anonymous namespace
+
+
+// write the vector v to a binary file
+template <class T>
+void write_binary(std::string const& filename, BasicDenseVector<T> const& v)
+{
+  write_payload(filename, binary_kind_vector, v.size(), 1, v.data());
+}
+
+
+// write the matrix A to a binary file
+template <class T>
+void write_binary(std::string const& filename, BasicDenseMatrix<T> const& A)
+{
+  write_payload(filename, binary_kind_matrix, A.rows(), A.cols(), A.data());
+}
+
+
+// map the file with the given name
+MappedFile::MappedFile(std::string const& filename)
+{
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open file '" + filename + "'");
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Cannot determine the size of file '" + filename + "'");
+  }
+
+  size_ = std::size_t(st.st_size);
+  if (size_ > 0) {
+    void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("Cannot map file '" + filename + "'");
+    }
+    data_ = static_cast<char const*>(p);
+  }
+  // the mapping stays valid after closing the file descriptor
+  ::close(fd);
+}
+
+
+MappedFile::MappedFile(MappedFile&& that) noexcept
+  : data_(std::exchange(that.data_, nullptr))
+  , size_(std::exchange(that.size_, 0))
+{}
+
+
+MappedFile& MappedFile::operator=(MappedFile&& that) noexcept
+{
+  std::swap(data_, that.data_);
+  std::swap(size_, that.size_);
+  return *this;
+}
+
+
+MappedFile::~MappedFile()
+{
+  if (data_)
+    ::munmap(const_cast<char*>(data_), size_);
+}
+
+
+// map the vector stored in the file
+template <class T>
+MappedDenseVector<T>::MappedDenseVector(std::string const& filename)
+  : file_(filename)
+{
+  size_type cols = 0;
+  data_ = read_payload<T>(file_, filename, binary_kind_vector, size_, cols);
+}
+
+
+// map the matrix stored in the file
+template <class T>
+MappedDenseMatrix<T>::MappedDenseMatrix(std::string const& filename)
+  : file_(filename)
+{
+  data_ = read_payload<T>(file_, filename, binary_kind_matrix, rows_, cols_);
+}
+
+
+// computes the matrix-vector product, y = Ax.
+template <class T>
+void MappedDenseMatrix<T>::mult(BasicDenseVector<T> const& x, BasicDenseVector<T>& y) const
+{
+  assert(x.size() == cols());
+  assert(y.size() == rows());
+  const_pointer a = data_;
+  const_pointer xp = x.data();
+  T* yp = y.data();
+  size_type const c = cols_;
+  parallel::for_each_block(rows_, parallel::num_row_blocks(rows_, rows_*cols_),
+    [=](size_type first, size_type last) {
+      for (size_type r = first; r < last; ++r)
+        yp[r] = dense_dot(a + r*c, xp, c);
+    });
+}
+
+
+// computes v3 = v2 + A * v1.
+template <class T>
+void MappedDenseMatrix<T>::mult_add(BasicDenseVector<T> const& v1, BasicDenseVector<T> const& v2,
+                                    BasicDenseVector<T>& v3) const
+{
+  assert(v1.size() == cols());
+  assert(v2.size() == rows());
+  assert(v3.size() == rows());
+  const_pointer a = data_;
+  const_pointer v1p = v1.data();
+  const_pointer v2p = v2.data();
+  T* v3p = v3.data();
+  size_type const c = cols_;
+  parallel::for_each_block(rows_, parallel::num_row_blocks(rows_, rows_*cols_),
+    [=](size_type first, size_type last) {
+      for (size_type r = first; r < last; ++r)
+        v3p[r] = v2p[r] + dense_dot(a + r*c, v1p, c);
+    });
+}
+
+
+// explicit instantiation for the element types used by the solvers
+template void write_binary(std::string const&, BasicDenseVector<double> const&);
+template void write_binary(std::string const&, BasicDenseVector<float> const&);
+template void write_binary(std::string const&, BasicDenseMatrix<double> const&);
+template void write_binary(std::string const&, BasicDenseMatrix<float> const&);
+
+template class MappedDenseVector<double>;
+template class MappedDenseVector<float>;
+template class MappedDenseMatrix<double>;
+template class MappedDenseMatrix<float>;
+
+} // end namespace scprog
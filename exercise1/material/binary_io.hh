@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "linear_algebra.hh"
+
+namespace scprog
+{
+  /// Header of the binary file format of dense vectors and matrices
+  /**
+   * A file consists of this 64-byte header followed by the entries, in row-wise order for
+   * matrices, starting at `payload_offset`. The payload offset is a multiple of the cache
+   * line size, so that the entries are aligned when the file is mapped to memory.
+   *
+   * The format is written in the byte order of the producing machine. `byte_order` holds
+   * the value 0x01020304, such that a file of a different byte order is detected on load.
+   **/
+  struct BinaryHeader
+  {
+    char          magic[8];       // "SCPROGDM"
+    std::uint32_t version;        // format version, see \ref binary_format_version
+    std::uint32_t kind;           // 1 = vector, 2 = matrix
+    std::uint32_t value_size;     // size of an entry in bytes, 4 = float, 8 = double
+    std::uint32_t byte_order;     // 0x01020304 in the byte order of the producer
+    std::uint64_t rows;           // number of rows, or the size of a vector
+    std::uint64_t cols;           // number of columns, 1 for a vector
+    std::uint64_t payload_offset; // offset of the first entry from the start of the file
+    char          reserved[16];   // zero
+  };
+
+  static_assert(sizeof(BinaryHeader) == 64, "The binary header must have a size of 64 bytes");
+
+  /// current version of the binary file format
+  constexpr std::uint32_t binary_format_version = 1;
+
+
+  /// Write the vector v to a binary file
+  template <class T>
+  void write_binary(std::string const& filename, BasicDenseVector<T> const& v);
+
+  /// Write the matrix A to a binary file
+  template <class T>
+  void write_binary(std::string const& filename, BasicDenseMatrix<T> const& A);
+
+
+  /// A read-only memory mapping of a complete file
+  /**
+   * The file is mapped on construction and unmapped on destruction. Pages are read from
+   * disk on first access only, so opening a file takes constant time.
+   **/
+  class MappedFile
+  {
+  public:
+    /// map the file with the given name, throws std::runtime_error on failure
+    explicit MappedFile(std::string const& filename);
+
+    MappedFile(MappedFile&& that) noexcept;
+    MappedFile& operator=(MappedFile&& that) noexcept;
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    ~MappedFile();
+
+    /// return a pointer to the first byte of the file
+    char const* data() const
+    {
+      return data_;
+    }
+
+    /// return the size of the file in bytes
+    std::size_t size() const
+    {
+      return size_;
+    }
+
+  private:
+    char const* data_ = nullptr;
+    std::size_t size_ = 0;
+  };
+
+
+  /// A read-only view of a vector in a memory-mapped binary file, see \ref write_binary
+  /**
+   * The entries are not copied. The view is a vector expression, so it can be used in
+   * arithmetic expressions or assigned to a \ref BasicDenseVector.
+   *
+   * \tparam T  The element type of the vector, must match the type in the file
+   **/
+  template <class T>
+  class MappedDenseVector
+      : public VectorExpr<MappedDenseVector<T>>
+  {
+  public:
+    using size_type     = std::size_t;
+    using value_type    = T;
+    using const_pointer = value_type const*;
+
+    /// map the vector stored in the file, throws std::runtime_error on an invalid file
+    explicit MappedDenseVector(std::string const& filename);
+
+    /// return the number of elements in the vector
+    size_type size() const
+    {
+      return size_;
+    }
+
+    /// return the vector entry v_i
+    value_type operator[](size_type i) const
+    {
+      assert(i < size_);
+      return data_[i];
+    }
+
+    /// return a pointer to the contiguous vector entries
+    const_pointer data() const
+    {
+      return data_;
+    }
+
+    /// return the i-th entry in expressions
+    value_type entry(size_type i) const
+    {
+      return data_[i];
+    }
+
+    /// the view reads only its i-th entry for the i-th entry of an expression
+    bool aliases(void const*) const
+    {
+      return false;
+    }
+
+  private:
+    MappedFile file_;
+    const_pointer data_ = nullptr;
+    size_type size_ = 0;
+  };
+
+
+  /// A read-only view of a matrix in a memory-mapped binary file, see \ref write_binary
+  /**
+   * The entries are not copied. The view provides the matrix-vector product `mult`, so it
+   * can be used as the operator of the iterative solvers, e.g. \ref cg. It is a matrix
+   * expression, so it can be assigned to a \ref BasicDenseMatrix to obtain a copy.
+   *
+   * \tparam T  The element type of the matrix, must match the type in the file
+   **/
+  template <class T>
+  class MappedDenseMatrix
+      : public MatrixExpr<MappedDenseMatrix<T>>
+  {
+  public:
+    using size_type     = std::size_t;
+    using value_type    = T;
+    using const_pointer = value_type const*;
+
+    /// map the matrix stored in the file, throws std::runtime_error on an invalid file
+    explicit MappedDenseMatrix(std::string const& filename);
+
+    /// return the number of rows in the matrix
+    size_type rows() const
+    {
+      return rows_;
+    }
+
+    /// return the number of columns in the matrix
+    size_type cols() const
+    {
+      return cols_;
+    }
+
+    /// access to i-th matrix row
+    const_pointer operator[](size_type r) const
+    {
+      assert(r < rows_);
+      return data_ + cols_ * r;
+    }
+
+    /// access to the (r,c)-th matrix element
+    value_type operator()(size_type r, size_type c) const
+    {
+      assert(r < rows_ && c < cols_);
+      return data_[cols_ * r + c];
+    }
+
+    /// return a pointer to the contiguous, row-wise matrix entries
+    const_pointer data() const
+    {
+      return data_;
+    }
+
+    /// computes the matrix-vector product, y = Ax.
+    void mult(BasicDenseVector<T> const& x, BasicDenseVector<T>& y) const;
+
+    /// computes v3 = v2 + A * v1.
+    void mult_add(BasicDenseVector<T> const& v1, BasicDenseVector<T> const& v2,
+                  BasicDenseVector<T>& v3) const;
+
+    /// return the number of entries in expressions
+    size_type size() const
+    {
+      return rows_ * cols_;
+    }
+
+    /// return the i-th entry, in row-wise order, in expressions
+    value_type entry(size_type i) const
+    {
+      return data_[i];
+    }
+
+    /// the view reads only its i-th entry for the i-th entry of an expression
+    bool aliases(void const*) const
+    {
+      return false;
+    }
+
+  private:
+    MappedFile file_;
+    const_pointer data_ = nullptr;
+    size_type rows_ = 0;
+    size_type cols_ = 0;
+  };
+
+
+  // views own the mapping and are not copied into expressions
+  template <class T>
+  struct ExprOperand<MappedDenseVector<T>>
+  {
+    using type = MappedDenseVector<T> const&;
+  };
+
+  template <class T>
+  struct ExprOperand<MappedDenseMatrix<T>>
+  {
+    using type = MappedDenseMatrix<T> const&;
+  };
+
+  extern template class MappedDenseVector<double>;
+  extern template class MappedDenseVector<float>;
+  extern template class MappedDenseMatrix<double>;
+  extern template class MappedDenseMatrix<float>;
+
+} // end namespace scprog
@@ -1,119 +1,220 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <utility>
 #include "linear_algebra.hh"
+#include "parallel.hh"
+#include "stencil.hh"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SCPROG_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
 
 namespace scprog {
 
+namespace {
+
+// fill the entries [first, last) with value v, in parallel in the first-touch mode
+template <class T>
+void parallel_fill(T* d, std::size_t first, std::size_t last, T v)
+{
+  if (!parallel::first_touch()) {
+    std::fill(d + first, d + last, v);
+    return;
+  }
+  parallel::for_each_block(last - first, [=](std::size_t b, std::size_t e) {
+    std::fill(d + first + b, d + first + e, v);
+  });
+}
+
+// fill the entries of a r x c matrix with value v, in parallel by blocks of rows in the
+// first-touch mode, matching the partition of the matrix-vector kernels
+template <class T>
+void parallel_fill_rows(T* d, std::size_t r, std::size_t c, T v)
+{
+  if (!parallel::first_touch()) {
+    std::fill(d, d + r*c, v);
+    return;
+  }
+  parallel::for_each_block(r, parallel::num_row_blocks(r, r*c), [=](std::size_t b, std::size_t e) {
+    std::fill(d + b*c, d + e*c, v);
+  });
+}
+
+} // end anonymous namespace
+
+
 // set all entries of the vector to value v
-DenseVector& DenseVector::operator=(value_type v)
+template <class T>
+BasicDenseVector<T>& BasicDenseVector<T>::operator=(value_type v)
 {
-  for (auto& v_i : data_)
-    v_i = v;
+  parallel_fill(data_.data(), 0, size(), v);
   return *this;
 }
 
 
+// resize vector to size s and fill new entries with value v
+template <class T>
+void BasicDenseVector<T>::resize(size_type s, value_type v)
+{
+  size_type old_size = size();
+  data_.resize(s);
+  if (s > old_size)
+    parallel_fill(data_.data(), old_size, s, v);
+}
+
+
 // perform update-assignment elementwise +=
-DenseVector& DenseVector::operator+=(DenseVector const& that)
+template <class T>
+BasicDenseVector<T>& BasicDenseVector<T>::operator+=(BasicDenseVector const& that)
 {
   assert(size() == that.size());
-  for (size_type i = 0; i < size(); ++i)
-    data_[i] += that.data_[i];
+  pointer d = data_.data();
+  const_pointer t = that.data_.data();
+  parallel::for_each_block(size(), [=](size_type first, size_type last) {
+    for (size_type i = first; i < last; ++i)
+      d[i] += t[i];
+  });
   return *this;
 }
 
 
 // perform update-assignment elementwise +=
-DenseVector& DenseVector::operator-=(DenseVector const& that)
+template <class T>
+BasicDenseVector<T>& BasicDenseVector<T>::operator-=(BasicDenseVector const& that)
 {
   assert(size() == that.size());
-  for (size_type i = 0; i < size(); ++i)
-    data_[i] -= that.data_[i];
+  pointer d = data_.data();
+  const_pointer t = that.data_.data();
+  parallel::for_each_block(size(), [=](size_type first, size_type last) {
+    for (size_type i = first; i < last; ++i)
+      d[i] -= t[i];
+  });
   return *this;
 }
 
 
 // perform update-assignment elementwise *= with a scalar
-DenseVector& DenseVector::operator*=(value_type s)
+template <class T>
+BasicDenseVector<T>& BasicDenseVector<T>::operator*=(value_type s)
 {
-  for (size_type i = 0; i < size(); ++i)
-    data_[i] *= s;
+  pointer d = data_.data();
+  parallel::for_each_block(size(), [=](size_type first, size_type last) {
+    for (size_type i = first; i < last; ++i)
+      d[i] *= s;
+  });
   return *this;
 }
 
 
 // perform update-assignment elementwise /= with a scalar
-DenseVector& DenseVector::operator/=(value_type s)
+template <class T>
+BasicDenseVector<T>& BasicDenseVector<T>::operator/=(value_type s)
 {
   assert(s != value_type(0));
-  for (size_type i = 0; i < size(); ++i)
-    data_[i] /= s;
+  pointer d = data_.data();
+  parallel::for_each_block(size(), [=](size_type first, size_type last) {
+    for (size_type i = first; i < last; ++i)
+      d[i] /= s;
+  });
   return *this;
 }
 
 
 // computes Y = a*X + Y.
-void DenseVector::axpy(value_type a, DenseVector const& x)
+template <class T>
+void BasicDenseVector<T>::axpy(value_type a, BasicDenseVector const& x)
 {
   assert(size() == x.size());
-  for (size_type i = 0; i < data_.size(); ++i)
-    data_[i] += a * x.data_[i];
+  pointer d = data_.data();
+  const_pointer xd = x.data_.data();
+  parallel::for_each_block(size(), [=](size_type first, size_type last) {
+    for (size_type i = first; i < last; ++i)
+      d[i] += a * xd[i];
+  });
 }
 
 
 // computes Y = a*Y + X.
-void DenseVector::aypx(value_type a, DenseVector const& x)
+template <class T>
+void BasicDenseVector<T>::aypx(value_type a, BasicDenseVector const& x)
 {
   assert(size() == x.size());
-  for (size_type i = 0; i < data_.size(); ++i)
-    data_[i] = a * data_[i]  + x.data_[i];
+  pointer d = data_.data();
+  const_pointer xd = x.data_.data();
+  parallel::for_each_block(size(), [=](size_type first, size_type last) {
+    for (size_type i = first; i < last; ++i)
+      d[i] = a * d[i]  + xd[i];
+  });
 }
 
 
 // return the two-norm ||vector||_2 = sqrt(sum_i v_i^2)
-typename DenseVector::value_type DenseVector::two_norm() const
+template <class T>
+typename BasicDenseVector<T>::value_type BasicDenseVector<T>::two_norm() const
 {
   using std::sqrt;
-  value_type result = 0;
-  for (auto const& d : data_)
-    result += d * d;
-  return sqrt(result);
+  return sqrt(unary_dot());
 }
 
 
 // return the infinity-norm ||vector||_inf = max_i(|v_i|)
-typename DenseVector::value_type DenseVector::inf_norm() const
+template <class T>
+typename BasicDenseVector<T>::value_type BasicDenseVector<T>::inf_norm() const
 {
   using std::abs;
   using std::max;
-  value_type result = 0;
-  for (auto const& d : data_)
-    result = max(result, value_type(abs(d)));
-  return result;
+  const_pointer d = data_.data();
+  return parallel::reduce_blocks(size(), value_type(0),
+    [=](size_type first, size_type last) {
+      value_type result = 0;
+      for (size_type i = first; i < last; ++i)
+        result = max(result, value_type(abs(d[i])));
+      return result;
+    },
+    [](value_type a, value_type b) { return max(a, b); });
 }
 
 
 // return v^T*v
-typename DenseVector::value_type DenseVector::unary_dot() const
+template <class T>
+typename BasicDenseVector<T>::value_type BasicDenseVector<T>::unary_dot() const
 {
-  value_type result = 0;
-  for (auto const& d : data_)
-    result += d*d;
-  return result;
+  const_pointer d = data_.data();
+  return parallel::reduce_blocks(size(), value_type(0),
+    [=](size_type first, size_type last) {
+      value_type result = 0;
+      for (size_type i = first; i < last; ++i)
+        result += d[i] * d[i];
+      return result;
+    },
+    std::plus<value_type>{});
 }
 
 
 // return v^T*v2
-typename DenseVector::value_type DenseVector::dot(DenseVector const& v2) const
+template <class T>
+typename BasicDenseVector<T>::value_type BasicDenseVector<T>::dot(BasicDenseVector const& v2) const
 {
   assert(v2.size() == size());
-  value_type result = 0;
-  for (size_type i = 0; i < size(); ++i)
-    result += data_[i] * v2.data_[i];
-  return result;
+  const_pointer d = data_.data();
+  const_pointer d2 = v2.data_.data();
+  return parallel::reduce_blocks(size(), value_type(0),
+    [=](size_type first, size_type last) {
+      value_type result = 0;
+      for (size_type i = first; i < last; ++i)
+        result += d[i] * d2[i];
+      return result;
+    },
+    std::plus<value_type>{});
 }
 
 // construct a matrix from initializer lists
-DenseMatrix::DenseMatrix(std::initializer_list<std::initializer_list<value_type>> l)
+template <class T>
+BasicDenseMatrix<T>::BasicDenseMatrix(std::initializer_list<std::initializer_list<value_type>> l)
 {
   // 1. determine number of entries
   size_type columns = 0;
@@ -129,11 +230,14 @@ DenseMatrix::DenseMatrix(std::initializer_list<std::initializer_list<value_type>
   data_.reserve(rows*columns);
   for (auto const& row : l)
     data_.insert(data_.end(), row.begin(), row.end());
+  rows_ = rows;
+  cols_ = columns;
 }
 
 
 // perform update-assignment elementwise +=
-DenseMatrix& DenseMatrix::operator+=(DenseMatrix const& that)
+template <class T>
+BasicDenseMatrix<T>& BasicDenseMatrix<T>::operator+=(BasicDenseMatrix const& that)
 {
   assert(rows() == that.rows());
   assert(cols() == that.cols());
@@ -144,7 +248,8 @@ DenseMatrix& DenseMatrix::operator+=(DenseMatrix const& that)
 
 
 // perform update-assignment elementwise +=
-DenseMatrix& DenseMatrix::operator-=(DenseMatrix const& that)
+template <class T>
+BasicDenseMatrix<T>& BasicDenseMatrix<T>::operator-=(BasicDenseMatrix const& that)
 {
   assert(rows() == that.rows());
   assert(cols() == that.cols());
@@ -155,55 +260,283 @@ DenseMatrix& DenseMatrix::operator-=(DenseMatrix const& that)
 
 
 // set all entries to v
-DenseMatrix& DenseMatrix::operator=(value_type v)
+template <class T>
+BasicDenseMatrix<T>& BasicDenseMatrix<T>::operator=(value_type v)
 {
-  for (auto& A_ij : data_)
-    A_ij = v;
+  parallel_fill_rows(data_.data(), rows_, cols_, v);
   return *this;
 }
 
 
-// matrix-vector product A*x
-DenseVector operator*(DenseMatrix const& A, DenseVector const& x)
+// resize matrix to rows r and columns c and fill new entries with value v
+template <class T>
+void BasicDenseMatrix<T>::resize(size_type r, size_type c, value_type v)
 {
-  using value_type = typename DenseMatrix::value_type;
-  DenseVector y(A.cols(), value_type(0));
-  A.mult(x, y);
-  return y;
+  size_type old_size = data_.size();
+  data_.resize(r*c);
+  rows_ = r;
+  cols_ = c;
+  if (old_size == 0)
+    parallel_fill_rows(data_.data(), r, c, v);
+  else if (r*c > old_size)
+    parallel_fill(data_.data(), old_size, r*c, v);
+}
+
+
+namespace {
+
+// Inner product of a matrix row with a vector, using four independent accumulators
+template <class T>
+T row_dot_scalar(T const* a, T const* x, std::size_t n)
+{
+  T s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  std::size_t c = 0;
+  for (; c + 4 <= n; c += 4) {
+    s0 += a[c]   * x[c];
+    s1 += a[c+1] * x[c+1];
+    s2 += a[c+2] * x[c+2];
+    s3 += a[c+3] * x[c+3];
+  }
+  for (; c < n; ++c)
+    s0 += a[c] * x[c];
+  return (s0 + s1) + (s2 + s3);
+}
+
+#ifdef SCPROG_HAVE_X86_SIMD
+
+// Inner product of a matrix row with a vector, using four AVX2 accumulators of 4 doubles
+__attribute__((target("avx2,fma")))
+double row_dot_avx2(double const* a, double const* x, std::size_t n)
+{
+  __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+  __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+  std::size_t c = 0;
+  for (; c + 16 <= n; c += 16) {
+    s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a+c),    _mm256_loadu_pd(x+c),    s0);
+    s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a+c+4),  _mm256_loadu_pd(x+c+4),  s1);
+    s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a+c+8),  _mm256_loadu_pd(x+c+8),  s2);
+    s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a+c+12), _mm256_loadu_pd(x+c+12), s3);
+  }
+  for (; c + 4 <= n; c += 4)
+    s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a+c), _mm256_loadu_pd(x+c), s0);
+
+  __m256d s = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
+  __m128d h = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+  double result = _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+  for (; c < n; ++c)
+    result += a[c] * x[c];
+  return result;
+}
+
+// Inner product of a matrix row with a vector, using four AVX-512 accumulators of 8 doubles
+__attribute__((target("avx512f")))
+double row_dot_avx512(double const* a, double const* x, std::size_t n)
+{
+  __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+  __m512d s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+  std::size_t c = 0;
+  for (; c + 32 <= n; c += 32) {
+    s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a+c),    _mm512_loadu_pd(x+c),    s0);
+    s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a+c+8),  _mm512_loadu_pd(x+c+8),  s1);
+    s2 = _mm512_fmadd_pd(_mm512_loadu_pd(a+c+16), _mm512_loadu_pd(x+c+16), s2);
+    s3 = _mm512_fmadd_pd(_mm512_loadu_pd(a+c+24), _mm512_loadu_pd(x+c+24), s3);
+  }
+  for (; c + 8 <= n; c += 8)
+    s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a+c), _mm512_loadu_pd(x+c), s0);
+
+  // masked load of the remainder
+  if (c < n) {
+    __mmask8 m = __mmask8((1u << (n - c)) - 1u);
+    s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a+c), _mm512_maskz_loadu_pd(m, x+c), s1);
+  }
+  alignas(64) double buf[8];
+  _mm512_store_pd(buf, _mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+  return ((buf[0] + buf[1]) + (buf[2] + buf[3])) + ((buf[4] + buf[5]) + (buf[6] + buf[7]));
+}
+
+// Inner product of a single precision matrix row with a vector, using four AVX2 accumulators
+// of 8 floats
+__attribute__((target("avx2,fma")))
+float row_dot_avx2_float(float const* a, float const* x, std::size_t n)
+{
+  __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+  __m256 s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+  std::size_t c = 0;
+  for (; c + 32 <= n; c += 32) {
+    s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a+c),    _mm256_loadu_ps(x+c),    s0);
+    s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a+c+8),  _mm256_loadu_ps(x+c+8),  s1);
+    s2 = _mm256_fmadd_ps(_mm256_loadu_ps(a+c+16), _mm256_loadu_ps(x+c+16), s2);
+    s3 = _mm256_fmadd_ps(_mm256_loadu_ps(a+c+24), _mm256_loadu_ps(x+c+24), s3);
+  }
+  for (; c + 8 <= n; c += 8)
+    s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a+c), _mm256_loadu_ps(x+c), s0);
+
+  alignas(32) float buf[8];
+  _mm256_store_ps(buf, _mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+  float result = ((buf[0] + buf[1]) + (buf[2] + buf[3])) + ((buf[4] + buf[5]) + (buf[6] + buf[7]));
+  for (; c < n; ++c)
+    result += a[c] * x[c];
+  return result;
+}
+
+#endif // SCPROG_HAVE_X86_SIMD
+
+using RowDot = double (*)(double const*, double const*, std::size_t);
+
+struct RowDotKernel
+{
+  RowDot f;
+  char const* name;
+};
+
+// Select the row kernel once, according to the features of the executing CPU
+RowDotKernel const& row_dot_kernel()
+{
+  static RowDotKernel const kernel = []() -> RowDotKernel {
+#ifdef SCPROG_HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+      return {row_dot_avx512, "avx512"};
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return {row_dot_avx2, "avx2"};
+#endif
+    return {row_dot_scalar<double>, "scalar"};
+  }();
+  return kernel;
+}
+
+using RowDotFloat = float (*)(float const*, float const*, std::size_t);
+
+// Select the single precision row kernel once, according to the features of the executing CPU
+RowDotFloat row_dot_kernel_float()
+{
+  static RowDotFloat const kernel = []() -> RowDotFloat {
+#ifdef SCPROG_HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return row_dot_avx2_float;
+#endif
+    return row_dot_scalar<float>;
+  }();
+  return kernel;
+}
+
+// The row kernel for the element type of the matrix
+RowDot select_row_dot(double const*)
+{
+  return row_dot_kernel().f;
+}
+
+RowDotFloat select_row_dot(float const*)
+{
+  return row_dot_kernel_float();
+}
+
+} // end anonymous namespace
+
+
+// return the name of the instruction set used by the dense matrix-vector kernels
+std::string simd_instruction_set()
+{
+  return row_dot_kernel().name;
+}
+
+
+// return the inner product of the contiguous arrays a and x of length n
+double dense_dot(double const* a, double const* x, std::size_t n)
+{
+  return row_dot_kernel().f(a, x, n);
+}
+
+
+// return the inner product of the contiguous arrays a and x of length n (single precision)
+float dense_dot(float const* a, float const* x, std::size_t n)
+{
+  return row_dot_kernel_float()(a, x, n);
+}
+
+
+// return the inner product of the r-th matrix row with the vector x
+template <class T>
+typename BasicDenseMatrix<T>::value_type
+BasicDenseMatrix<T>::dot_row(size_type r, BasicDenseVector<T> const& x) const
+{
+  assert(r < rows());
+  assert(x.size() == cols());
+  return select_row_dot(const_pointer{})(data_.data() + r*cols_, x.data(), cols_);
 }
 
 
 // computes the matrix-vector product, y = Ax.
-void DenseMatrix::mult(DenseVector const& x, DenseVector& y) const
+template <class T>
+void BasicDenseMatrix<T>::mult(BasicDenseVector<T> const& x, BasicDenseVector<T>& y) const
 {
   assert(x.size() == cols());
   assert(y.size() == rows());
-  for (size_type r = 0; r < rows(); ++r) {
-    y[r] = value_type(0);
-    value_type const* row = (*this)[r];
-    for (size_type c = 0; c < cols(); ++c)
-      y[r] += row[c]*x[c];
-  }
+  auto row_dot = select_row_dot(const_pointer{});
+  const_pointer a = data_.data();
+  const_pointer xp = x.data();
+  pointer yp = y.data();
+  size_type const c = cols();
+  parallel::for_each_block(rows(), parallel::num_row_blocks(rows(), data_.size()),
+    [=](size_type first, size_type last) {
+      for (size_type r = first; r < last; ++r)
+        yp[r] = row_dot(a + r*c, xp, c);
+    });
 }
 
 
 // computes v3 = v2 + A * v1.
-void DenseMatrix::mult_add(DenseVector const& v1, DenseVector const& v2, DenseVector& v3) const
+template <class T>
+void BasicDenseMatrix<T>::mult_add(BasicDenseVector<T> const& v1, BasicDenseVector<T> const& v2,
+                                   BasicDenseVector<T>& v3) const
 {
   assert(v1.size() == cols());
   assert(v2.size() == rows());
   assert(v3.size() == rows());
-  for (size_type r = 0; r < rows(); ++r) {
-    v3[r] = v2[r];
-    value_type const* row = (*this)[r];
-    for (size_type c = 0; c < cols(); ++c)
-      v3[r] += row[c]*v1[c];
-  }
+  auto row_dot = select_row_dot(const_pointer{});
+  const_pointer a = data_.data();
+  const_pointer v1p = v1.data();
+  const_pointer v2p = v2.data();
+  pointer v3p = v3.data();
+  size_type const c = cols();
+  parallel::for_each_block(rows(), parallel::num_row_blocks(rows(), data_.size()),
+    [=](size_type first, size_type last) {
+      for (size_type r = first; r < last; ++r)
+        v3p[r] = v2p[r] + row_dot(a + r*c, v1p, c);
+    });
+}
+
+
+// computes the matrix-vector product, y = Ax, and returns x^T*y in the same pass.
+template <class T>
+typename BasicDenseMatrix<T>::value_type
+BasicDenseMatrix<T>::mult_dot(BasicDenseVector<T> const& x, BasicDenseVector<T>& y) const
+{
+  assert(x.size() == cols());
+  assert(y.size() == rows());
+  assert(rows() == cols());
+  auto row_dot = select_row_dot(const_pointer{});
+  const_pointer a = data_.data();
+  const_pointer xp = x.data();
+  pointer yp = y.data();
+  size_type const c = cols();
+  return parallel::reduce_blocks(rows(), parallel::num_row_blocks(rows(), data_.size()), value_type(0),
+    [=](size_type first, size_type last) {
+      value_type result = 0;
+      for (size_type r = first; r < last; ++r) {
+        yp[r] = row_dot(a + r*c, xp, c);
+        result += xp[r] * yp[r];
+      }
+      return result;
+    },
+    std::plus<value_type>{});
 }
 
 
 // computes Y = a*X + Y.
-void DenseMatrix::axpy(value_type a, DenseMatrix const& X)
+template <class T>
+void BasicDenseMatrix<T>::axpy(value_type a, BasicDenseMatrix const& X)
 {
   assert(rows() == X.rows());
   assert(cols() == X.cols());
@@ -213,7 +546,8 @@ void DenseMatrix::axpy(value_type a, DenseMatrix const& X)
 
 
 // computes Y = a*Y + X.
-void DenseMatrix::aypx(value_type a, DenseMatrix const& X)
+template <class T>
+void BasicDenseMatrix<T>::aypx(value_type a, BasicDenseMatrix const& X)
 {
   assert(rows() == X.rows());
   assert(cols() == X.cols());
@@ -222,29 +556,783 @@ void DenseMatrix::aypx(value_type a, DenseMatrix const& X)
 }
 
 
+namespace {
+
+// Block sizes of the matrix-matrix product: a MR x NR tile of C is kept in registers, a
+// KC x NR micro-panel of B in the L1 cache, a MC x KC block of A in the L2 cache, and a
+// KC x NC panel of B in the L3 cache.
+constexpr std::size_t gemm_mr = 6;
+constexpr std::size_t gemm_nr = 8;
+constexpr std::size_t gemm_mc = 96;
+constexpr std::size_t gemm_kc = 256;
+constexpr std::size_t gemm_nc = 4096;
+
+// Computes the tile C += A*B with A a packed MR x kc micro-panel and B a packed kc x NR micro-panel
+void gemm_kernel_generic(std::size_t kc, double const* a, double const* b, double* c, std::size_t ldc)
+{
+  double ab[gemm_mr][gemm_nr] = {};
+  for (std::size_t p = 0; p < kc; ++p, a += gemm_mr, b += gemm_nr)
+    for (std::size_t i = 0; i < gemm_mr; ++i)
+      for (std::size_t j = 0; j < gemm_nr; ++j)
+        ab[i][j] += a[i] * b[j];
+
+  for (std::size_t i = 0; i < gemm_mr; ++i)
+    for (std::size_t j = 0; j < gemm_nr; ++j)
+      c[i*ldc + j] += ab[i][j];
+}
+
+#ifdef SCPROG_HAVE_X86_SIMD
+
+// Computes the tile C += A*B with the 6x8 tile held in twelve AVX2 registers
+__attribute__((target("avx2,fma")))
+void gemm_kernel_avx2(std::size_t kc, double const* a, double const* b, double* c, std::size_t ldc)
+{
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+  __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+  for (std::size_t p = 0; p < kc; ++p, a += gemm_mr, b += gemm_nr) {
+    __m256d b0 = _mm256_loadu_pd(b);
+    __m256d b1 = _mm256_loadu_pd(b + 4);
+    __m256d ai;
+    ai = _mm256_broadcast_sd(a);   c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+    ai = _mm256_broadcast_sd(a+1); c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+    ai = _mm256_broadcast_sd(a+2); c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+    ai = _mm256_broadcast_sd(a+3); c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+    ai = _mm256_broadcast_sd(a+4); c40 = _mm256_fmadd_pd(ai, b0, c40); c41 = _mm256_fmadd_pd(ai, b1, c41);
+    ai = _mm256_broadcast_sd(a+5); c50 = _mm256_fmadd_pd(ai, b0, c50); c51 = _mm256_fmadd_pd(ai, b1, c51);
+  }
+
+  __m256d const tile[gemm_mr][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+  for (std::size_t i = 0; i < gemm_mr; ++i) {
+    double* ci = c + i*ldc;
+    _mm256_storeu_pd(ci,     _mm256_add_pd(_mm256_loadu_pd(ci),     tile[i][0]));
+    _mm256_storeu_pd(ci + 4, _mm256_add_pd(_mm256_loadu_pd(ci + 4), tile[i][1]));
+  }
+}
+
+#endif // SCPROG_HAVE_X86_SIMD
+
+using GemmKernel = void (*)(std::size_t, double const*, double const*, double*, std::size_t);
+
+struct GemmKernelInfo
+{
+  GemmKernel f;
+  char const* name;
+};
+
+// Select the micro-kernel once, according to the features of the executing CPU
+GemmKernelInfo const& gemm_kernel_info()
+{
+  static GemmKernelInfo const kernel = []() -> GemmKernelInfo {
+#ifdef SCPROG_HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return {gemm_kernel_avx2, "avx2"};
+#endif
+    return {gemm_kernel_generic, "scalar"};
+  }();
+  return kernel;
+}
+
+GemmKernel gemm_kernel()
+{
+  return gemm_kernel_info().f;
+}
+
+// Pack the mc x kc block of A, scaled by alpha, into micro-panels of MR rows, stored
+// column by column and padded with zeros
+void pack_a(std::size_t mc, std::size_t kc, double alpha, double const* A, std::size_t lda, double* buf)
+{
+  for (std::size_t i0 = 0; i0 < mc; i0 += gemm_mr) {
+    std::size_t mr = std::min(gemm_mr, mc - i0);
+    for (std::size_t p = 0; p < kc; ++p, buf += gemm_mr) {
+      for (std::size_t i = 0; i < mr; ++i)
+        buf[i] = alpha * A[(i0+i)*lda + p];
+      for (std::size_t i = mr; i < gemm_mr; ++i)
+        buf[i] = 0;
+    }
+  }
+}
+
+// Pack the kc x nc panel of B into micro-panels of NR columns, stored row by row and
+// padded with zeros
+void pack_b(std::size_t kc, std::size_t nc, double const* B, std::size_t ldb, double* buf)
+{
+  for (std::size_t j0 = 0; j0 < nc; j0 += gemm_nr) {
+    std::size_t nr = std::min(gemm_nr, nc - j0);
+    for (std::size_t p = 0; p < kc; ++p, buf += gemm_nr) {
+      for (std::size_t j = 0; j < nr; ++j)
+        buf[j] = B[p*ldb + j0 + j];
+      for (std::size_t j = nr; j < gemm_nr; ++j)
+        buf[j] = 0;
+    }
+  }
+}
+
+// Multiply the packed mc x kc block of A with the packed kc x nc panel of B and add to C
+void gemm_macro_kernel(std::size_t mc, std::size_t nc, std::size_t kc,
+                       double const* a, double const* b, double* C, std::size_t ldc)
+{
+  GemmKernel kernel = gemm_kernel();
+  double tile[gemm_mr * gemm_nr];
+  for (std::size_t j0 = 0; j0 < nc; j0 += gemm_nr) {
+    std::size_t nr = std::min(gemm_nr, nc - j0);
+    for (std::size_t i0 = 0; i0 < mc; i0 += gemm_mr) {
+      std::size_t mr = std::min(gemm_mr, mc - i0);
+      double const* ap = a + i0*kc;
+      double const* bp = b + j0*kc;
+      double* cp = C + i0*ldc + j0;
+      if (mr == gemm_mr && nr == gemm_nr) {
+        kernel(kc, ap, bp, cp, ldc);
+      } else {
+        // partial tile at the boundary of C is computed in a local buffer
+        std::fill(tile, tile + gemm_mr*gemm_nr, 0.0);
+        kernel(kc, ap, bp, tile, gemm_nr);
+        for (std::size_t i = 0; i < mr; ++i)
+          for (std::size_t j = 0; j < nr; ++j)
+            cp[i*ldc + j] += tile[i*gemm_nr + j];
+      }
+    }
+  }
+}
+
+} // end anonymous namespace
+
+
+// return the name of the instruction set used by the gemm micro-kernel
+std::string gemm_instruction_set()
+{
+  return gemm_kernel_info().name;
+}
+
+
+// Computes the general matrix-matrix product C = alpha*A*B + beta*C
+void gemm(double alpha, DenseMatrix const& A, DenseMatrix const& B, double beta, DenseMatrix& C)
+{
+  using size_type = DenseMatrix::size_type;
+  assert(A.cols() == B.rows());
+  assert(C.rows() == A.rows());
+  assert(C.cols() == B.cols());
+
+  size_type const m = A.rows(), n = B.cols(), k = A.cols();
+  if (m == 0 || n == 0)
+    return;
+
+  if (beta != 1.0) {
+    for (size_type i = 0; i < m; ++i) {
+      double* ci = C[i];
+      for (size_type j = 0; j < n; ++j)
+        ci[j] = beta == 0.0 ? 0.0 : beta * ci[j];
+    }
+  }
+  if (alpha == 0.0 || k == 0)
+    return;
+
+  double const* a = A[0];
+  double const* b = B[0];
+  double* c = C[0];
+
+  std::vector<double> b_packed(gemm_kc * ((std::min(gemm_nc, n) + gemm_nr - 1) / gemm_nr) * gemm_nr);
+  size_type const row_blocks = (m + gemm_mc - 1) / gemm_mc;
+
+  for (size_type jc = 0; jc < n; jc += gemm_nc) {
+    size_type nc = std::min(gemm_nc, n - jc);
+    for (size_type pc = 0; pc < k; pc += gemm_kc) {
+      size_type kc = std::min(gemm_kc, k - pc);
+      pack_b(kc, nc, b + pc*n + jc, n, b_packed.data());
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(parallel::num_threads()) if(parallel::num_threads() > 1 && row_blocks > 1)
+#endif
+      {
+        std::vector<double> a_packed(gemm_mc * gemm_kc);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (size_type ib = 0; ib < row_blocks; ++ib) {
+          size_type ic = ib * gemm_mc;
+          size_type mc = std::min(gemm_mc, m - ic);
+          pack_a(mc, kc, alpha, a + ic*k + pc, k, a_packed.data());
+          gemm_macro_kernel(mc, nc, kc, a_packed.data(), b_packed.data(), c + ic*n + jc, n);
+        }
+      }
+    }
+  }
+}
+
+
+// Computes the general matrix-matrix product C = alpha*A*B + beta*C in single precision
+void gemm(float alpha, BasicDenseMatrix<float> const& A, BasicDenseMatrix<float> const& B,
+          float beta, BasicDenseMatrix<float>& C)
+{
+  using size_type = BasicDenseMatrix<float>::size_type;
+  assert(A.cols() == B.rows());
+  assert(C.rows() == A.rows());
+  assert(C.cols() == B.cols());
+
+  size_type const n = B.cols(), k = A.cols();
+  for (size_type i = 0; i < A.rows(); ++i) {
+    float* ci = C[i];
+    for (size_type j = 0; j < n; ++j)
+      ci[j] = beta == 0.0f ? 0.0f : beta * ci[j];
+    for (size_type p = 0; p < k; ++p) {
+      float const a_ip = alpha * A(i,p);
+      float const* bp = B[p];
+      for (size_type j = 0; j < n; ++j)
+        ci[j] += a_ip * bp[j];
+    }
+  }
+}
+
+
+// computes the matrix-matrix product, C = A*B, with C resized if necessary.
+template <class T>
+void BasicDenseMatrix<T>::mult(BasicDenseMatrix const& B, BasicDenseMatrix& C) const
+{
+  assert(&C != this && &C != &B);
+  C.resize(rows(), B.cols());
+  gemm(T(1), *this, B, T(0), C);
+}
+
+
+// explicit instantiation for the element types used by the solvers
+template class BasicDenseVector<double>;
+template class BasicDenseVector<float>;
+template class BasicDenseMatrix<double>;
+template class BasicDenseMatrix<float>;
+
+
 // Setup a matrix according to a Laplacian equation on a 2D-grid using a five-point-stencil.
 // Results in a matrix A of size (m*n) x (m*n)
 void laplacian_setup(DenseMatrix& A, std::size_t m, std::size_t n)
 {
-  A.resize(m*n, m*n);
-  A = 0;
-
-  for (std::size_t i = 0; i < m; i++) {
-    for (std::size_t j = 0; j < n; j++) {
-      std::size_t row = i * n + j;
-      A(row, row) = 4;
-      if (j < n - 1) A(row, row + 1) = -1;
-      if (i < m - 1) A(row, row + n) = -1;
-      if (j > 0)     A(row, row - 1) = -1;
-      if (i > 0)     A(row, row - n) = -1;
+  stencil_setup(A, five_point_stencil(), m, n);
+}
+
+
+// constructor of a sparse matrix from its compressed arrays
+CRSMatrix::CRSMatrix(size_type r, size_type c, index_array offsets, index_array indices,
+                     value_array values)
+  : offsets_(std::move(offsets))
+  , indices_(std::move(indices))
+  , values_(std::move(values))
+  , rows_(r)
+  , cols_(c)
+{
+  assert(offsets_.size() == r+1);
+  assert(indices_.size() == values_.size());
+  assert(offsets_.back() == values_.size());
+}
+
+
+// return the (r,c)-th matrix element if stored, or 0 otherwise
+typename CRSMatrix::value_type CRSMatrix::operator()(size_type r, size_type c) const
+{
+  assert(r < rows_);
+  auto first = indices_.begin() + offsets_[r];
+  auto last  = indices_.begin() + offsets_[r+1];
+  auto it = std::lower_bound(first, last, c);
+  return it != last && *it == c ? values_[it - indices_.begin()] : value_type(0);
+}
+
+
+// matrix-vector product A*x
+DenseVector operator*(CRSMatrix const& A, DenseVector const& x)
+{
+  using value_type = typename CRSMatrix::value_type;
+  DenseVector y(A.rows(), value_type(0));
+  A.mult(x, y);
+  return y;
+}
+
+
+// computes the matrix-vector product, y = Ax.
+void CRSMatrix::mult(DenseVector const& x, DenseVector& y) const
+{
+  assert(x.size() == cols());
+  assert(y.size() == rows());
+  size_type const* offsets = offsets_.data();
+  size_type const* indices = indices_.data();
+  value_type const* values = values_.data();
+  value_type const* xp = x.data();
+  value_type* yp = y.data();
+  parallel::for_each_block(rows(), parallel::num_row_blocks(rows(), values_.size()),
+    [=](size_type first, size_type last) {
+      for (size_type r = first; r < last; ++r) {
+        value_type f = 0;
+        for (size_type k = offsets[r]; k < offsets[r+1]; ++k)
+          f += values[k] * xp[indices[k]];
+        yp[r] = f;
+      }
+    });
+}
+
+
+// computes v3 = v2 + A * v1.
+void CRSMatrix::mult_add(DenseVector const& v1, DenseVector const& v2, DenseVector& v3) const
+{
+  assert(v1.size() == cols());
+  assert(v2.size() == rows());
+  assert(v3.size() == rows());
+  size_type const* offsets = offsets_.data();
+  size_type const* indices = indices_.data();
+  value_type const* values = values_.data();
+  value_type const* v1p = v1.data();
+  value_type const* v2p = v2.data();
+  value_type* v3p = v3.data();
+  parallel::for_each_block(rows(), parallel::num_row_blocks(rows(), values_.size()),
+    [=](size_type first, size_type last) {
+      for (size_type r = first; r < last; ++r) {
+        value_type f = v2p[r];
+        for (size_type k = offsets[r]; k < offsets[r+1]; ++k)
+          f += values[k] * v1p[indices[k]];
+        v3p[r] = f;
+      }
+    });
+}
+
+
+// computes the matrix-vector product, y = Ax, and returns x^T*y in the same pass.
+typename CRSMatrix::value_type CRSMatrix::mult_dot(DenseVector const& x, DenseVector& y) const
+{
+  assert(x.size() == cols());
+  assert(y.size() == rows());
+  assert(rows() == cols());
+  size_type const* offsets = offsets_.data();
+  size_type const* indices = indices_.data();
+  value_type const* values = values_.data();
+  value_type const* xp = x.data();
+  value_type* yp = y.data();
+  return parallel::reduce_blocks(rows(), parallel::num_row_blocks(rows(), values_.size()), value_type(0),
+    [=](size_type first, size_type last) {
+      value_type result = 0;
+      for (size_type r = first; r < last; ++r) {
+        value_type f = 0;
+        for (size_type k = offsets[r]; k < offsets[r+1]; ++k)
+          f += values[k] * xp[indices[k]];
+        yp[r] = f;
+        result += xp[r] * f;
+      }
+      return result;
+    },
+    std::plus<value_type>{});
+}
+
+
+// computes the product with a block of vectors, Y = AX.
+void CRSMatrix::mult(DenseMatrix const& X, DenseMatrix& Y) const
+{
+  assert(X.rows() == cols());
+  assert(Y.rows() == rows());
+  assert(X.cols() == Y.cols());
+  size_type const k = X.cols();
+  for (size_type r = 0; r < rows(); ++r) {
+    value_type* y = Y[r];
+    for (size_type j = 0; j < k; ++j)
+      y[j] = 0;
+    for (size_type l = offsets_[r]; l < offsets_[r+1]; ++l) {
+      value_type const a = values_[l];
+      value_type const* x = X[indices_[l]];
+      for (size_type j = 0; j < k; ++j)
+        y[j] += a * x[j];
+    }
+  }
+}
+
+
+// Setup a sparse matrix according to a Laplacian equation on a 2D-grid using a five-point-stencil.
+// The rows are assembled in parallel, with increasing column index in each row.
+void laplacian_setup(CRSMatrix& A, std::size_t m, std::size_t n)
+{
+  stencil_setup(A, five_point_stencil(), m, n);
+}
+
+
+// matrix-free operator application A*x
+DenseVector operator*(LaplacianOperator const& A, DenseVector const& x)
+{
+  using value_type = typename LaplacianOperator::value_type;
+  DenseVector y(A.rows(), value_type(0));
+  A.mult(x, y);
+  return y;
+}
+
+
+// computes the operator application, y = Ax, by applying the five-point-stencil row by row.
+void LaplacianOperator::mult(DenseVector const& x, DenseVector& y) const
+{
+  assert(x.size() == cols());
+  assert(y.size() == rows());
+  for (size_type i = 0; i < m_; ++i) {
+    for (size_type j = 0; j < n_; ++j) {
+      size_type row = i * n_ + j;
+      value_type f = 4 * x[row];
+      if (j < n_ - 1) f -= x[row + 1];
+      if (i < m_ - 1) f -= x[row + n_];
+      if (j > 0)      f -= x[row - 1];
+      if (i > 0)      f -= x[row - n_];
+      y[row] = f;
+    }
+  }
+}
+
+
+// computes v3 = v2 + A * v1.
+void LaplacianOperator::mult_add(DenseVector const& v1, DenseVector const& v2, DenseVector& v3) const
+{
+  assert(v1.size() == cols());
+  assert(v2.size() == rows());
+  assert(v3.size() == rows());
+  for (size_type i = 0; i < m_; ++i) {
+    for (size_type j = 0; j < n_; ++j) {
+      size_type row = i * n_ + j;
+      value_type f = v2[row] + 4 * v1[row];
+      if (j < n_ - 1) f -= v1[row + 1];
+      if (i < m_ - 1) f -= v1[row + n_];
+      if (j > 0)      f -= v1[row - 1];
+      if (i > 0)      f -= v1[row - n_];
+      v3[row] = f;
     }
   }
 }
 
 
+// computes the operator application, y = Ax, and returns x^T*y in the same pass.
+typename LaplacianOperator::value_type LaplacianOperator::mult_dot(DenseVector const& x, DenseVector& y) const
+{
+  assert(x.size() == cols());
+  assert(y.size() == rows());
+  value_type const* xp = x.data();
+  value_type* yp = y.data();
+  value_type result = 0;
+  for (size_type i = 0; i < m_; ++i) {
+    for (size_type j = 0; j < n_; ++j) {
+      size_type row = i * n_ + j;
+      value_type f = 4 * xp[row];
+      if (j < n_ - 1) f -= xp[row + 1];
+      if (i < m_ - 1) f -= xp[row + n_];
+      if (j > 0)      f -= xp[row - 1];
+      if (i > 0)      f -= xp[row - n_];
+      yp[row] = f;
+      result += xp[row] * f;
+    }
+  }
+  return result;
+}
+
+
+// computes the operator application to a block of vectors, Y = AX.
+void LaplacianOperator::mult(DenseMatrix const& X, DenseMatrix& Y) const
+{
+  assert(X.rows() == cols());
+  assert(Y.rows() == rows());
+  assert(X.cols() == Y.cols());
+  size_type const k = X.cols();
+  for (size_type i = 0; i < m_; ++i) {
+    for (size_type j = 0; j < n_; ++j) {
+      size_type row = i * n_ + j;
+      value_type* y = Y[row];
+      value_type const* x = X[row];
+      for (size_type l = 0; l < k; ++l)
+        y[l] = 4 * x[l];
+      if (j < n_ - 1) { x = X[row + 1];  for (size_type l = 0; l < k; ++l) y[l] -= x[l]; }
+      if (i < m_ - 1) { x = X[row + n_]; for (size_type l = 0; l < k; ++l) y[l] -= x[l]; }
+      if (j > 0)      { x = X[row - 1];  for (size_type l = 0; l < k; ++l) y[l] -= x[l]; }
+      if (i > 0)      { x = X[row - n_]; for (size_type l = 0; l < k; ++l) y[l] -= x[l]; }
+    }
+  }
+}
+
+
+// Computes x += alpha*p and r -= alpha*q in a single pass and returns r^T*r
+DenseVector::value_type cg_update(DenseVector::value_type alpha, DenseVector const& p,
+                                  DenseVector const& q, DenseVector& x, DenseVector& r)
+{
+  using value_type = DenseVector::value_type;
+  assert(p.size() == x.size());
+  assert(q.size() == r.size());
+  assert(x.size() == r.size());
+  value_type const* pp = p.data();
+  value_type const* qp = q.data();
+  value_type* xp = x.data();
+  value_type* rp = r.data();
+  return parallel::reduce_blocks(r.size(), value_type(0),
+    [=](std::size_t first, std::size_t last) {
+      value_type result = 0;
+      for (std::size_t i = first; i < last; ++i) {
+        xp[i] += alpha * pp[i];
+        rp[i] -= alpha * qp[i];
+        result += rp[i] * rp[i];
+      }
+      return result;
+    },
+    std::plus<value_type>{});
+}
+
+
+// Computes the inner products d_j = X_j^T*Y_j of all columns j
+void column_dots(DenseMatrix const& X, DenseMatrix const& Y, DenseVector& d)
+{
+  assert(X.rows() == Y.rows() && X.cols() == Y.cols());
+  assert(d.size() == X.cols());
+  std::size_t const k = X.cols();
+  double* s = d.data();
+  d = 0;
+  for (std::size_t i = 0; i < X.rows(); ++i) {
+    double const* x = X[i];
+    double const* y = Y[i];
+    for (std::size_t j = 0; j < k; ++j)
+      s[j] += x[j] * y[j];
+  }
+}
+
+
+// Computes X_j += alpha_j*P_j and R_j -= alpha_j*Q_j and returns rho_j = R_j^T*R_j
+void cg_block_update(DenseVector const& alpha, DenseMatrix const& P, DenseMatrix const& Q,
+                     DenseMatrix& X, DenseMatrix& R, DenseVector& rho)
+{
+  std::size_t const k = X.cols();
+  assert(alpha.size() == k && rho.size() == k);
+  assert(P.rows() == X.rows() && Q.rows() == X.rows() && R.rows() == X.rows());
+  double const* a = alpha.data();
+  double* s = rho.data();
+  rho = 0;
+  for (std::size_t i = 0; i < X.rows(); ++i) {
+    double const* p = P[i];
+    double const* q = Q[i];
+    double* x = X[i];
+    double* r = R[i];
+    for (std::size_t j = 0; j < k; ++j) {
+      x[j] += a[j] * p[j];
+      r[j] -= a[j] * q[j];
+      s[j] += r[j] * r[j];
+    }
+  }
+}
+
+
+// Computes P_j = R_j + beta_j*P_j for all columns j
+void block_aypx(DenseVector const& beta, DenseMatrix& P, DenseMatrix const& R)
+{
+  std::size_t const k = P.cols();
+  assert(beta.size() == k);
+  assert(R.rows() == P.rows() && R.cols() == k);
+  double const* b = beta.data();
+  for (std::size_t i = 0; i < P.rows(); ++i) {
+    double* p = P[i];
+    double const* r = R[i];
+    for (std::size_t j = 0; j < k; ++j)
+      p[j] = r[j] + b[j] * p[j];
+  }
+}
+
+
+// Computes the Gram matrix G = V^T*V of the basis vectors V_0,...,V_{m-1} in a single pass
+void gram_matrix(std::vector<DenseVector> const& V, DenseMatrix& G)
+{
+  std::size_t const m = V.size();
+  assert(m > 0);
+  std::size_t const n = V[0].size();
+  std::size_t const nb = parallel::num_blocks(n);
+  G.resize(m, m);
+
+  // one partial Gram matrix per block, summed in block order for reproducible results
+  std::vector<double> partial(nb * m * m);
+  double* g = partial.data();
+  std::vector<double const*> v(m);
+  for (std::size_t a = 0; a < m; ++a) {
+    assert(V[a].size() == n);
+    v[a] = V[a].data();
+  }
+  double const* const* vp = v.data();
+  parallel::for_each_block(n, nb, [=](std::size_t first, std::size_t last) {
+    double* gb = g + parallel::block_index(first, nb, n) * m * m;
+    for (std::size_t a = 0; a < m; ++a)
+      for (std::size_t b = 0; b <= a; ++b)
+        gb[a*m + b] = dense_dot(vp[a] + first, vp[b] + first, last - first);
+  });
+
+  for (std::size_t a = 0; a < m; ++a) {
+    for (std::size_t b = 0; b <= a; ++b) {
+      double sum = 0.0;
+      for (std::size_t k = 0; k < nb; ++k)
+        sum += g[k*m*m + a*m + b];
+      G(a,b) = G(b,a) = sum;
+    }
+  }
+}
+
+
+namespace {
+
+// Computes y = beta*y + V*c for beta = 0 or 1 in a single pass
+void basis_combination(std::vector<DenseVector> const& V, std::vector<double> const& c,
+                       DenseVector& y, bool add)
+{
+  std::size_t const m = V.size();
+  assert(m > 0 && c.size() == m);
+  std::vector<double const*> v(m);
+  for (std::size_t a = 0; a < m; ++a) {
+    assert(V[a].size() == y.size());
+    v[a] = V[a].data();
+  }
+  double const* const* vp = v.data();
+  double const* cp = c.data();
+  double* yp = y.data();
+  parallel::for_each_block(y.size(), [=](std::size_t first, std::size_t last) {
+    // the block of y stays in cache while the basis vectors are streamed through
+    for (std::size_t a = 0; a < m; ++a) {
+      double const ca = cp[a];
+      double const* va = vp[a];
+      if (a == 0 && !add) {
+        for (std::size_t i = first; i < last; ++i)
+          yp[i] = ca * va[i];
+      } else {
+        for (std::size_t i = first; i < last; ++i)
+          yp[i] += ca * va[i];
+      }
+    }
+  });
+}
+
+} // end anonymous namespace
+
+
+// Computes y = V*c
+void basis_mult(std::vector<DenseVector> const& V, std::vector<double> const& c, DenseVector& y)
+{
+  basis_combination(V, c, y, false);
+}
+
+
+// Computes y += V*c
+void basis_mult_add(std::vector<DenseVector> const& V, std::vector<double> const& c,
+                    DenseVector& y)
+{
+  basis_combination(V, c, y, true);
+}
+
+
+// Write the history as CSV
+void IterationTelemetry::write_csv(std::ostream& out) const
+{
+  auto precision = out.precision(std::numeric_limits<real_type>::max_digits10);
+  out << "iteration,resid,time\n";
+  for (std::size_t i = 0; i < size(); ++i) {
+    Entry const& e = (*this)[i];
+    out << e.iteration << ',' << e.resid << ',' << e.time << '\n';
+  }
+  out.precision(precision);
+}
+
+
+// Write the history as JSON array
+void IterationTelemetry::write_json(std::ostream& out) const
+{
+  auto precision = out.precision(std::numeric_limits<real_type>::max_digits10);
+  out << '[';
+  for (std::size_t i = 0; i < size(); ++i) {
+    Entry const& e = (*this)[i];
+    out << (i > 0 ? ",\n " : "") << "{\"iteration\":" << e.iteration << ",\"resid\":";
+    // JSON has no representation of nan and inf, e.g. of a diverged solve
+    if (std::isfinite(e.resid))
+      out << e.resid;
+    else
+      out << "null";
+    out << ",\"time\":" << e.time << '}';
+  }
+  out << "]\n";
+  out.precision(precision);
+}
+
+
+// Append a row with diagonal entry a and the entry b coupling it to the previous row
+void LanczosTridiagonal::push_back(double a, double b)
+{
+  if (!diag_.empty())
+    offdiag_.push_back(b);
+  diag_.push_back(a);
+}
+
+
+// Append the row of a cg iteration. With the step lengths alpha_j and the coefficients
+// beta_j = rho_j/rho_{j-1}, the Lanczos matrix has the entries
+//   T_jj = 1/alpha_j + beta_j/alpha_{j-1},  T_{j-1,j} = sqrt(beta_j)/alpha_{j-1}
+void LanczosTridiagonal::add_cg_step(double alpha, double beta)
+{
+  if (diag_.empty())
+    push_back(1.0 / alpha, 0.0);
+  else
+    push_back(1.0 / alpha + beta / alpha_, std::sqrt(beta) / alpha_);
+  alpha_ = alpha;
+}
+
+
+// Remove all rows
+void LanczosTridiagonal::clear()
+{
+  diag_.clear();
+  offdiag_.clear();
+  alpha_ = 0.0;
+}
+
+
+// Return the number of eigenvalues less than x, by the number of negative pivots of the
+// LDL^T factorization of T - x*I (Sturm sequence)
+std::size_t LanczosTridiagonal::count_below(double x) const
+{
+  std::size_t count = 0;
+  double q = 1.0;
+  for (std::size_t i = 0; i < diag_.size(); ++i) {
+    double e2 = i > 0 ? offdiag_[i-1] * offdiag_[i-1] : 0.0;
+    q = diag_[i] - x - (i > 0 ? e2 / q : 0.0);
+    if (q == 0.0)
+      q = -std::numeric_limits<double>::epsilon() * (std::abs(x) + std::abs(diag_[i]) + 1.0);
+    if (q < 0.0)
+      ++count;
+  }
+  return count;
+}
+
+
+// Return the i-th smallest eigenvalue by bisection in the Gershgorin interval
+double LanczosTridiagonal::eigenvalue(std::size_t i) const
+{
+  std::size_t const k = diag_.size();
+  assert(i < k);
+  double lo = std::numeric_limits<double>::max(), hi = std::numeric_limits<double>::lowest();
+  for (std::size_t j = 0; j < k; ++j) {
+    double radius = (j > 0 ? std::abs(offdiag_[j-1]) : 0.0)
+                  + (j + 1 < k ? std::abs(offdiag_[j]) : 0.0);
+    lo = std::min(lo, diag_[j] - radius);
+    hi = std::max(hi, diag_[j] + radius);
+  }
+
+  // invariant: count_below(lo) <= i < count_below(hi)
+  double const eps = std::numeric_limits<double>::epsilon();
+  while (hi - lo > 2 * eps * std::max(std::abs(lo), std::abs(hi))) {
+    double mid = lo + (hi - lo) / 2;
+    if (mid <= lo || mid >= hi)
+      break;
+    if (count_below(mid) > i)
+      hi = mid;
+    else
+      lo = mid;
+  }
+  return lo + (hi - lo) / 2;
+}
+
+
 // Iteration finished according to residual value r
 bool BasicIteration::finished(real_type const& r)
 {
+  if (telemetry_)
+    telemetry_->record(i_, r);
+
   bool result = false;
   if (converged(r))
     result = finished_ = true;
@@ -275,7 +1363,7 @@ void BasicIteration::print_resid()
 {
   if (!quite_ && i_ % cycle_ == 0) {
     if (i_ != last_print_) { // Avoid multiple print-outs in same iteration
-      std::cout << "iteration " << i_ << ": resid " << resid() << std::endl;
+      std::cout << "iteration " << i_ << ": resid " << resid() << '\n';
       last_print_ = i_;
     }
   }
@@ -291,42 +1379,8 @@ int BasicIteration::error_code() const
               << resid() << " is actual final residual. \n"
               << relresid() << " is actual relative tolerance achieved. \n"
               << "Relative tol: " << rtol_ << "  Absolute tol: " << atol_ << '\n'
-              << "Convergence:  " << pow(relresid(), 1.0 / double(iterations())) << std::endl;
+              << "Convergence:  " << pow(relresid(), 1.0 / double(iterations())) << '\n';
   return error_;
 }
 
-
-// Apply the conjugate gradient algorithm to the linear system A*x = b and return the number of iterations
-int cg(DenseMatrix const& A, DenseVector& x, DenseVector const& b, BasicIteration& iter)
-{
-  using std::abs;
-  using Vector = DenseVector;
-  using Scalar = typename DenseVector::value_type;
-  using Real   = typename BasicIteration::real_type;
-
-  Scalar rho(0), rho_1(0), alpha(0);
-  Vector p(b), q(b), z(b);
-  Vector r(b - A*x);
-
-  rho = r.unary_dot();
-  while (! iter.finished(Real(sqrt(abs(rho))))) {
-    ++iter;
-    if (iter.first())
-      p = r;
-    else
-      p.aypx(rho / rho_1, r); // p = r + (rho / rho_1) * p;
-
-    q = A * p;
-    alpha = rho / p.dot(q);
-
-    x.axpy(alpha, p);     // x += alpha * p
-    r.axpy(-alpha, q);    // r -= alpha * q
-
-    rho_1 = rho;
-    rho = r.unary_dot();  // rho = r^T * r
-  }
-
-  return iter;
-}
-
 } // end namespace scprog
\ No newline at end of file
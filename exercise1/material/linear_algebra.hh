@@ -1,19 +1,77 @@
+#pragma once
+
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <complex>
+#include <functional>
 #include <initializer_list>
+#include <iosfwd>
+#include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "allocator.hh"
+#include "parallel.hh"
+
 namespace scprog
 {
+  /// Base class of all vector expressions, i.e., vectors and lazy arithmetic expressions of
+  /// vectors, that are evaluated elementwise on assignment to a vector
+  template <class E>
+  struct VectorExpr
+  {
+    /// return the expression as its derived type
+    E const& derived() const
+    {
+      return static_cast<E const&>(*this);
+    }
+  };
+
+  /// Base class of all matrix expressions, i.e., matrices and lazy arithmetic expressions of
+  /// matrices, that are evaluated elementwise on assignment to a matrix
+  template <class E>
+  struct MatrixExpr
+  {
+    /// return the expression as its derived type
+    E const& derived() const
+    {
+      return static_cast<E const&>(*this);
+    }
+  };
+
+  /// Evaluate op(d_i, e_i) for all entries i in [0, n) of the expression e in a single loop,
+  /// parallel over nb blocks
+  template <class E, class T, class Op>
+  void evaluate_expr(E const& e, T* d, std::size_t n, std::size_t nb, Op op)
+  {
+    parallel::for_each_block(n, nb, [&e, d, op](std::size_t first, std::size_t last) {
+      for (std::size_t i = first; i < last; ++i)
+        op(d[i], expr_entry(e, i));
+    });
+  }
+
   /// A contiguous vector with vector-space operations
-  class DenseVector
+  /**
+   * The entries are stored cache-line aligned, see \ref AlignedAllocator, and filled in
+   * parallel on construction, such that memory pages are first touched by the threads of
+   * the vector kernels.
+   *
+   * The arithmetic operators +, - and * return lazy expressions, see \ref VectorExpr, that
+   * are evaluated in a single fused loop on assignment, without temporary vectors.
+   *
+   * \tparam T  The element type of the vector, e.g. double or float
+   **/
+  template <class T>
+  class BasicDenseVector
+      : public VectorExpr<BasicDenseVector<T>>
   {
   public:
 
     using size_type       = std::size_t;
-    using value_type      = double;
+    using value_type      = T;
     using reference       = value_type&;
     using const_reference = value_type const&;
     using pointer         = value_type*;
@@ -24,27 +82,49 @@ namespace scprog
   public:
 
     /// default constructor, creates an empty vector of size 0
-    DenseVector() = default;
+    BasicDenseVector() = default;
 
     /// constructor of vector with size s and all entries initialized with value v
-    explicit DenseVector(size_type s, value_type v = value_type{})
-      : data_(s, v)
-    {}
+    explicit BasicDenseVector(size_type s, value_type v = value_type{})
+      : data_(s)
+    {
+      *this = v;
+    }
 
     /// constructor with vector entries initialized by initializer_list
-    explicit DenseVector(std::initializer_list<value_type> l)
+    explicit BasicDenseVector(std::initializer_list<value_type> l)
       : data_(l.begin(), l.end())
     {}
 
-    /// set all entries of the vector to value v
-    DenseVector& operator=(value_type v);
+    /// constructor of vector from a vector expression, evaluated in a single loop
+    template <class E>
+    BasicDenseVector(VectorExpr<E> const& expr)
+      : data_(expr_size(expr.derived()))
+    {
+      evaluate_expr(expr.derived(), data(), size(), expr_blocks(expr.derived()),
+                    [](reference d, value_type v) { d = v; });
+    }
 
-    /// resize vector to size s and fill new entries with value v
-    void resize(size_type s, value_type v = value_type{})
+    /// assign a vector expression, evaluated in a single loop
+    template <class E>
+    BasicDenseVector& operator=(VectorExpr<E> const& expr)
     {
-      data_.resize(s, v);
+      // expressions that read other entries than the i-th of this vector use a temporary
+      if (expr_aliases(expr.derived(), data()))
+        return *this = BasicDenseVector(expr);
+
+      data_.resize(expr_size(expr.derived()));
+      evaluate_expr(expr.derived(), data(), size(), expr_blocks(expr.derived()),
+                    [](reference d, value_type v) { d = v; });
+      return *this;
     }
 
+    /// set all entries of the vector to value v
+    BasicDenseVector& operator=(value_type v);
+
+    /// resize vector to size s and fill new entries with value v
+    void resize(size_type s, value_type v = value_type{});
+
     /// return the number of elements in the vector
     size_type size() const
     {
@@ -56,16 +136,42 @@ namespace scprog
   public:
 
     /// perform update-assignment elementwise +=
-    DenseVector& operator+=(DenseVector const& that);
+    BasicDenseVector& operator+=(BasicDenseVector const& that);
 
     /// perform update-assignment elementwise +=
-    DenseVector& operator-=(DenseVector const& that);
+    BasicDenseVector& operator-=(BasicDenseVector const& that);
 
     /// perform update-assignment elementwise *= with a scalar
-    DenseVector& operator*=(value_type s);
+    BasicDenseVector& operator*=(value_type s);
 
     /// perform update-assignment elementwise /= with a scalar
-    DenseVector& operator/=(value_type s);
+    BasicDenseVector& operator/=(value_type s);
+
+    /// perform update-assignment elementwise += with a vector expression
+    template <class E>
+    BasicDenseVector& operator+=(VectorExpr<E> const& expr)
+    {
+      if (expr_aliases(expr.derived(), data()))
+        return *this += BasicDenseVector(expr);
+
+      assert(size() == expr_size(expr.derived()));
+      evaluate_expr(expr.derived(), data(), size(), expr_blocks(expr.derived()),
+                    [](reference d, value_type v) { d += v; });
+      return *this;
+    }
+
+    /// perform update-assignment elementwise -= with a vector expression
+    template <class E>
+    BasicDenseVector& operator-=(VectorExpr<E> const& expr)
+    {
+      if (expr_aliases(expr.derived(), data()))
+        return *this -= BasicDenseVector(expr);
+
+      assert(size() == expr_size(expr.derived()));
+      evaluate_expr(expr.derived(), data(), size(), expr_blocks(expr.derived()),
+                    [](reference d, value_type v) { d -= v; });
+      return *this;
+    }
 
 
   // ----- element access functions  -------------------------------------------
@@ -85,39 +191,27 @@ namespace scprog
       return data_[i];
     }
 
-
-  // ----- binary operations  ---------------------------------------------------
-  public:
-
-    /// addition of two vectors
-    friend DenseVector operator+(DenseVector lhs, DenseVector const& rhs)
+    /// return a pointer to the contiguous vector entries
+    pointer data()
     {
-      return lhs += rhs;
+      return data_.data();
     }
 
-    /// subtraction of two vectors
-    friend DenseVector operator-(DenseVector lhs, DenseVector const& rhs)
+    /// return a pointer to the contiguous vector entries (const variant)
+    const_pointer data() const
     {
-      return lhs -= rhs;
+      return data_.data();
     }
 
-    /// multiplication of the vector with a scalar from the right, i.e. vec * s
-    friend DenseVector operator*(DenseVector vec, value_type s)
-    {
-      return vec *= s;
-    }
 
-    /// multiplication of the vector with a scalar from the left, i.e. s * vec
-    friend DenseVector operator*(value_type s, DenseVector vec)
-    {
-      return vec *= s;
-    }
+  // ----- binary operations  ---------------------------------------------------
+  public:
 
     /// computes Y = a*X + Y.
-    void axpy(value_type a, DenseVector const& X);
+    void axpy(value_type a, BasicDenseVector const& X);
 
     /// computes Y = a*Y + X.
-    void aypx(value_type a, DenseVector const& X);
+    void aypx(value_type a, BasicDenseVector const& X);
 
 
   // ----- reduction operators  ------------------------------------------------
@@ -133,23 +227,41 @@ namespace scprog
     value_type unary_dot() const;
 
     /// return v^T*v2
-    value_type dot(DenseVector const& v2) const;
+    value_type dot(BasicDenseVector const& v2) const;
 
 
   // ----- data members  -------------------------------------------------------
   private:
 
-    std::vector<value_type> data_;
+    std::vector<value_type, AlignedAllocator<value_type>> data_;
   };
 
+  /// The vector with double precision entries
+  using DenseVector = BasicDenseVector<double>;
+
+  extern template class BasicDenseVector<double>;
+  extern template class BasicDenseVector<float>;
+
 
   /// A dense matrix with row-wise contiguous storage and matrix-matrix as well as
   /// matrix-vector operations.
-  class DenseMatrix
+  /**
+   * The entries are stored cache-line aligned and filled in parallel on construction,
+   * by the blocks of rows that the matrix-vector kernels use, see
+   * \ref parallel::set_first_touch().
+   *
+   * The elementwise operators +, - and the scaling with a scalar return lazy expressions,
+   * see \ref MatrixExpr. The matrix-vector product A*x returns a lazy vector expression.
+   *
+   * \tparam T  The element type of the matrix, e.g. double or float
+   **/
+  template <class T>
+  class BasicDenseMatrix
+      : public MatrixExpr<BasicDenseMatrix<T>>
   {
   public:
     using size_type       = std::size_t;
-    using value_type      = double;
+    using value_type      = T;
     using reference       = value_type&;
     using const_reference = value_type const&;
     using pointer         = value_type*;
@@ -160,28 +272,50 @@ namespace scprog
   public:
 
     /// default constructor, creates and empty matrix of size 0x0
-    DenseMatrix() = default;
+    BasicDenseMatrix() = default;
 
     /// constructor of matrix with rows r, columns c and all entries initialized with value v
-    explicit DenseMatrix(size_type r, size_type c, value_type v = value_type{})
-      : data_(r*c, v)
+    explicit BasicDenseMatrix(size_type r, size_type c, value_type v = value_type{})
+      : data_(r*c)
       , rows_(r)
       , cols_(c)
-    {}
+    {
+      *this = v;
+    }
 
     /// constructor with matrix entries initialized by initializer_list
-    explicit DenseMatrix(std::initializer_list<std::initializer_list<value_type>> l);
+    explicit BasicDenseMatrix(std::initializer_list<std::initializer_list<value_type>> l);
+
+    /// constructor of matrix from a matrix expression, evaluated in a single loop
+    template <class E>
+    BasicDenseMatrix(MatrixExpr<E> const& expr)
+      : data_(expr_size(expr.derived()))
+      , rows_(expr.derived().rows())
+      , cols_(expr.derived().cols())
+    {
+      evaluate_expr(expr.derived(), data(), data_.size(),
+                    parallel::num_row_blocks(rows_, data_.size()),
+                    [](reference d, value_type v) { d = v; });
+    }
+
+    /// assign a matrix expression, evaluated in a single loop
+    template <class E>
+    BasicDenseMatrix& operator=(MatrixExpr<E> const& expr)
+    {
+      data_.resize(expr_size(expr.derived()));
+      rows_ = expr.derived().rows();
+      cols_ = expr.derived().cols();
+      evaluate_expr(expr.derived(), data(), data_.size(),
+                    parallel::num_row_blocks(rows_, data_.size()),
+                    [](reference d, value_type v) { d = v; });
+      return *this;
+    }
 
     /// set all entries to v
-    DenseMatrix& operator=(value_type v);
+    BasicDenseMatrix& operator=(value_type v);
 
     /// resize matrix to rows r and columns c and fill new entries with value v
-    void resize(size_type r, size_type c, value_type v = value_type{})
-    {
-      data_.resize(r*c, v);
-      rows_ = r;
-      cols_ = c;
-    }
+    void resize(size_type r, size_type c, value_type v = value_type{});
 
     /// return the number of rows in the matrix
     size_type rows() const
@@ -225,30 +359,508 @@ namespace scprog
       return data_[cols_ * r + c];
     }
 
+    /// return a pointer to the contiguous, row-wise matrix entries
+    pointer data()
+    {
+      return data_.data();
+    }
+
+    /// return a pointer to the contiguous, row-wise matrix entries (const variant)
+    const_pointer data() const
+    {
+      return data_.data();
+    }
+
 
   // ----- binary operations  ---------------------------------------------------
   public:
 
     /// perform update-assignment elementwise +=
-    DenseMatrix& operator+=(DenseMatrix const& that);
+    BasicDenseMatrix& operator+=(BasicDenseMatrix const& that);
 
     /// perform update-assignment elementwise +=
-    DenseMatrix& operator-=(DenseMatrix const& that);
+    BasicDenseMatrix& operator-=(BasicDenseMatrix const& that);
+
+    /// perform update-assignment elementwise += with a matrix expression
+    template <class E>
+    BasicDenseMatrix& operator+=(MatrixExpr<E> const& expr)
+    {
+      assert(rows() == expr.derived().rows() && cols() == expr.derived().cols());
+      evaluate_expr(expr.derived(), data(), data_.size(),
+                    parallel::num_row_blocks(rows_, data_.size()),
+                    [](reference d, value_type v) { d += v; });
+      return *this;
+    }
+
+    /// perform update-assignment elementwise -= with a matrix expression
+    template <class E>
+    BasicDenseMatrix& operator-=(MatrixExpr<E> const& expr)
+    {
+      assert(rows() == expr.derived().rows() && cols() == expr.derived().cols());
+      evaluate_expr(expr.derived(), data(), data_.size(),
+                    parallel::num_row_blocks(rows_, data_.size()),
+                    [](reference d, value_type v) { d -= v; });
+      return *this;
+    }
+
+    /// return the inner product of the r-th matrix row with the vector x
+    value_type dot_row(size_type r, BasicDenseVector<T> const& x) const;
+
+    /// computes the matrix-vector product, y = Ax.
+    void mult(BasicDenseVector<T> const& x, BasicDenseVector<T>& y) const;
+
+    /// computes v3 = v2 + A * v1.
+    void mult_add(BasicDenseVector<T> const& v1, BasicDenseVector<T> const& v2,
+                  BasicDenseVector<T>& v3) const;
+
+    /// computes the matrix-vector product, y = Ax, and returns x^T*y in the same pass.
+    value_type mult_dot(BasicDenseVector<T> const& x, BasicDenseVector<T>& y) const;
+
+    /// computes Y = a*X + Y.
+    void axpy(value_type a, BasicDenseMatrix const& X);
+
+    /// computes Y = a*Y + X.
+    void aypx(value_type a, BasicDenseMatrix const& X);
+
+
+  // ----- matrix-matrix operations  -------------------------------------------
+  public:
+
+    /// matrix-matrix product A*B
+    friend BasicDenseMatrix operator*(BasicDenseMatrix const& A, BasicDenseMatrix const& B)
+    {
+      BasicDenseMatrix C;
+      A.mult(B, C);
+      return C;
+    }
+
+    /// computes the matrix-matrix product, C = A*B, with C resized if necessary.
+    void mult(BasicDenseMatrix const& B, BasicDenseMatrix& C) const;
+
+
+  // ----- data members  -------------------------------------------------------
+  private:
+
+    std::vector<value_type, AlignedAllocator<value_type>> data_;
+    size_type rows_ = 0;
+    size_type cols_ = 0;
+  };
+
+  /// The matrix with double precision entries
+  using DenseMatrix = BasicDenseMatrix<double>;
+
+  extern template class BasicDenseMatrix<double>;
+  extern template class BasicDenseMatrix<float>;
+
+
+  // ----- expression templates -------------------------------------------------
+
+  /// return the i-th entry of a vector
+  template <class T>
+  T expr_entry(BasicDenseVector<T> const& v, std::size_t i)
+  {
+    return v.data()[i];
+  }
+
+  /// return the i-th entry of a matrix in row-wise order
+  template <class T>
+  T expr_entry(BasicDenseMatrix<T> const& A, std::size_t i)
+  {
+    return A.data()[i];
+  }
+
+  /// return the i-th entry of an expression
+  template <class E>
+  auto expr_entry(E const& e, std::size_t i) -> decltype(e.entry(i))
+  {
+    return e.entry(i);
+  }
+
+  /// return the number of entries of a vector
+  template <class T>
+  std::size_t expr_size(BasicDenseVector<T> const& v)
+  {
+    return v.size();
+  }
+
+  /// return the number of entries of a matrix
+  template <class T>
+  std::size_t expr_size(BasicDenseMatrix<T> const& A)
+  {
+    return A.rows() * A.cols();
+  }
+
+  /// return the number of entries of an expression
+  template <class E>
+  auto expr_size(E const& e) -> decltype(e.size())
+  {
+    return e.size();
+  }
+
+  /// return the number of blocks a vector or a leaf expression is split into for parallel
+  /// evaluation, the second argument selects the overload by priority
+  template <class E>
+  std::size_t expr_blocks(E const& e, long)
+  {
+    return parallel::num_blocks(expr_size(e));
+  }
+
+  /// return the number of blocks a composite expression is split into for parallel evaluation
+  template <class E>
+  auto expr_blocks(E const& e, int) -> decltype(e.blocks())
+  {
+    return e.blocks();
+  }
+
+  /// return the number of blocks an expression is split into for parallel evaluation
+  template <class E>
+  std::size_t expr_blocks(E const& e)
+  {
+    return expr_blocks(e, 0);
+  }
+
+  /// A vector or matrix reads its i-th entry only when the i-th entry is evaluated, thus
+  /// it can be assigned to itself elementwise
+  template <class T>
+  bool expr_aliases(BasicDenseVector<T> const&, void const*)
+  {
+    return false;
+  }
+
+  template <class T>
+  bool expr_aliases(BasicDenseMatrix<T> const&, void const*)
+  {
+    return false;
+  }
+
+  /// return whether the expression reads other than the i-th entries from the storage p
+  template <class E>
+  auto expr_aliases(E const& e, void const* p) -> decltype(e.aliases(p))
+  {
+    return e.aliases(p);
+  }
+
+  /// Operands of expressions: vectors and matrices are stored by reference, expressions by
+  /// value, so that expressions can be returned from functions and stored in variables
+  template <class E>
+  struct ExprOperand
+  {
+    using type = E;
+  };
+
+  template <class T>
+  struct ExprOperand<BasicDenseVector<T>>
+  {
+    using type = BasicDenseVector<T> const&;
+  };
+
+  template <class T>
+  struct ExprOperand<BasicDenseMatrix<T>>
+  {
+    using type = BasicDenseMatrix<T> const&;
+  };
+
+
+  /// Lazy elementwise expression f(a_i, b_i) of two vector or matrix expressions
+  /**
+   * \tparam Base  Either VectorExpr or MatrixExpr
+   **/
+  template <template <class> class Base, class Functor, class A, class B>
+  class BinaryExpr
+      : public Base<BinaryExpr<Base, Functor, A, B>>
+  {
+  public:
+    using value_type = typename A::value_type;
+
+    BinaryExpr(Functor f, A const& a, B const& b)
+      : f_(f)
+      , a_(a)
+      , b_(b)
+    {
+      assert(expr_size(a) == expr_size(b));
+    }
+
+    value_type entry(std::size_t i) const
+    {
+      return f_(expr_entry(a_, i), expr_entry(b_, i));
+    }
+
+    std::size_t size() const { return expr_size(a_); }
+    std::size_t rows() const { return a_.rows(); }
+    std::size_t cols() const { return a_.cols(); }
+
+    std::size_t blocks() const
+    {
+      return std::max(expr_blocks(a_), expr_blocks(b_));
+    }
+
+    bool aliases(void const* p) const
+    {
+      return expr_aliases(a_, p) || expr_aliases(b_, p);
+    }
+
+  private:
+    Functor f_;
+    typename ExprOperand<A>::type a_;
+    typename ExprOperand<B>::type b_;
+  };
+
+
+  /// Lazy expression s * a_i of a vector or matrix expression scaled by a scalar
+  /**
+   * \tparam Base  Either VectorExpr or MatrixExpr
+   **/
+  template <template <class> class Base, class A>
+  class ScaledExpr
+      : public Base<ScaledExpr<Base, A>>
+  {
+  public:
+    using value_type = typename A::value_type;
+
+    ScaledExpr(value_type s, A const& a)
+      : s_(s)
+      , a_(a)
+    {}
+
+    value_type entry(std::size_t i) const
+    {
+      return s_ * expr_entry(a_, i);
+    }
+
+    std::size_t size() const { return expr_size(a_); }
+    std::size_t rows() const { return a_.rows(); }
+    std::size_t cols() const { return a_.cols(); }
+
+    std::size_t blocks() const
+    {
+      return expr_blocks(a_);
+    }
+
+    bool aliases(void const* p) const
+    {
+      return expr_aliases(a_, p);
+    }
+
+  private:
+    value_type s_;
+    typename ExprOperand<A>::type a_;
+  };
+
+
+  /// Lazy matrix-vector product A*x, where the i-th entry is the product of the i-th row
+  /// of A with x
+  template <class T>
+  class MatVecExpr
+      : public VectorExpr<MatVecExpr<T>>
+  {
+  public:
+    using value_type = T;
+
+    MatVecExpr(BasicDenseMatrix<T> const& A, BasicDenseVector<T> const& x)
+      : A_(A)
+      , x_(x)
+    {
+      assert(A.cols() == x.size());
+    }
+
+    value_type entry(std::size_t i) const
+    {
+      return A_.dot_row(i, x_);
+    }
+
+    std::size_t size() const { return A_.rows(); }
+
+    /// the rows are split as in BasicDenseMatrix::mult, by the number of matrix entries
+    std::size_t blocks() const
+    {
+      return parallel::num_row_blocks(A_.rows(), A_.rows() * A_.cols());
+    }
+
+    bool aliases(void const* p) const
+    {
+      return x_.data() == p;
+    }
+
+  private:
+    BasicDenseMatrix<T> const& A_;
+    BasicDenseVector<T> const& x_;
+  };
+
+
+  /// addition of two vector expressions
+  template <class A, class B>
+  BinaryExpr<VectorExpr, std::plus<>, A, B> operator+(VectorExpr<A> const& a, VectorExpr<B> const& b)
+  {
+    return {std::plus<>{}, a.derived(), b.derived()};
+  }
+
+  /// subtraction of two vector expressions
+  template <class A, class B>
+  BinaryExpr<VectorExpr, std::minus<>, A, B> operator-(VectorExpr<A> const& a, VectorExpr<B> const& b)
+  {
+    return {std::minus<>{}, a.derived(), b.derived()};
+  }
+
+  /// multiplication of a vector expression with a scalar from the left, i.e. s * vec
+  template <class A>
+  ScaledExpr<VectorExpr, A> operator*(typename A::value_type s, VectorExpr<A> const& a)
+  {
+    return {s, a.derived()};
+  }
+
+  /// multiplication of a vector expression with a scalar from the right, i.e. vec * s
+  template <class A>
+  ScaledExpr<VectorExpr, A> operator*(VectorExpr<A> const& a, typename A::value_type s)
+  {
+    return {s, a.derived()};
+  }
+
+  /// matrix vector product A*x
+  template <class T>
+  MatVecExpr<T> operator*(BasicDenseMatrix<T> const& A, BasicDenseVector<T> const& x)
+  {
+    return {A, x};
+  }
+
+  /// addition of two matrix expressions
+  template <class A, class B>
+  BinaryExpr<MatrixExpr, std::plus<>, A, B> operator+(MatrixExpr<A> const& a, MatrixExpr<B> const& b)
+  {
+    assert(a.derived().rows() == b.derived().rows());
+    return {std::plus<>{}, a.derived(), b.derived()};
+  }
+
+  /// subtraction of two matrix expressions
+  template <class A, class B>
+  BinaryExpr<MatrixExpr, std::minus<>, A, B> operator-(MatrixExpr<A> const& a, MatrixExpr<B> const& b)
+  {
+    assert(a.derived().rows() == b.derived().rows());
+    return {std::minus<>{}, a.derived(), b.derived()};
+  }
+
+  /// multiplication of a matrix expression with a scalar from the left, i.e. s * A
+  template <class A>
+  ScaledExpr<MatrixExpr, A> operator*(typename A::value_type s, MatrixExpr<A> const& a)
+  {
+    return {s, a.derived()};
+  }
+
+  /// multiplication of a matrix expression with a scalar from the right, i.e. A * s
+  template <class A>
+  ScaledExpr<MatrixExpr, A> operator*(MatrixExpr<A> const& a, typename A::value_type s)
+  {
+    return {s, a.derived()};
+  }
+
+
+  /// Computes the general matrix-matrix product C = alpha*A*B + beta*C
+  /**
+   * The product is blocked for the cache hierarchy: panels of A and B are packed into
+   * contiguous buffers and a register-blocked micro-kernel updates small tiles of C.
+   * The micro-kernel is selected at runtime by the features of the CPU. If compiled with
+   * OpenMP, the blocks of rows of C are distributed over \ref parallel::num_threads()
+   * threads. The result does not depend on the number of threads.
+   *
+   * [[ expects: A.cols() == B.rows() ]]
+   * [[ expects: C.rows() == A.rows() && C.cols() == B.cols() ]]
+   **/
+  void gemm(double alpha, DenseMatrix const& A, DenseMatrix const& B, double beta, DenseMatrix& C);
+
+  /// Computes the general matrix-matrix product C = alpha*A*B + beta*C in single precision,
+  /// with a simple loop over rows
+  void gemm(float alpha, BasicDenseMatrix<float> const& A, BasicDenseMatrix<float> const& B,
+            float beta, BasicDenseMatrix<float>& C);
 
-    /// addition of two matrices
-    friend DenseMatrix operator+(DenseMatrix lhs, DenseMatrix const& rhs)
+
+  /// Return the name of the instruction set used by the dense matrix-vector kernels,
+  /// selected at runtime by the features of the CPU: "avx512", "avx2", or "scalar".
+  std::string simd_instruction_set();
+
+  /// Return the name of the instruction set used by the micro-kernel of gemm, selected at
+  /// runtime by the features of the CPU: "avx2" or "scalar".
+  std::string gemm_instruction_set();
+
+  /// Return the inner product of the contiguous arrays a and x of length n, e.g., a matrix
+  /// row times a vector, computed by the kernel of the dense matrix-vector product
+  double dense_dot(double const* a, double const* x, std::size_t n);
+
+  /// Return the inner product of the contiguous arrays a and x of length n (single precision)
+  float dense_dot(float const* a, float const* x, std::size_t n);
+
+
+  /// A sparse matrix in compressed row storage (CRS) with matrix-vector operations.
+  /// Memory and the cost of a matrix-vector product are proportional to the number
+  /// of nonzeros.
+  class CRSMatrix
+  {
+  public:
+    using size_type       = std::size_t;
+    using value_type      = double;
+    using reference       = value_type&;
+    using const_reference = value_type const&;
+    using pointer         = value_type*;
+    using const_pointer   = value_type const*;
+
+    /// cache-line aligned storage of the compressed arrays, not initialized on allocation
+    using index_array = std::vector<size_type, AlignedAllocator<size_type>>;
+    using value_array = std::vector<value_type, AlignedAllocator<value_type>>;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    /// default constructor, creates an empty matrix of size 0x0
+    CRSMatrix() = default;
+
+    /// constructor of matrix with rows r, columns c and the compressed arrays
+    /**
+     * \param offsets  Row offsets of size r+1 into the index and value arrays
+     * \param indices  Column indices of the nonzeros, sorted within each row
+     * \param values   The nonzero values corresponding to the column indices
+     **/
+    CRSMatrix(size_type r, size_type c, index_array offsets, index_array indices,
+              value_array values);
+
+    /// return the number of rows in the matrix
+    size_type rows() const
     {
-      return lhs += rhs;
+      return rows_;
     }
 
-    /// subtraction of two matrices
-    friend DenseMatrix operator-(DenseMatrix lhs, DenseMatrix const& rhs)
+    /// return the number of columns in the matrix
+    size_type cols() const
     {
-      return lhs -= rhs;
+      return cols_;
+    }
+
+    /// return the number of stored nonzeros
+    size_type nnz() const
+    {
+      return values_.size();
     }
 
+
+  // ----- element access functions  -------------------------------------------
+  public:
+
+    /// return the (r,c)-th matrix element if stored, or 0 otherwise
+    value_type operator()(size_type r, size_type c) const;
+
+    /// row offsets into the index and value arrays, of size rows()+1
+    index_array const& offsets() const { return offsets_; }
+
+    /// column indices of the stored nonzeros
+    index_array const& indices() const { return indices_; }
+
+    /// values of the stored nonzeros
+    value_array const& values() const { return values_; }
+
+
+  // ----- binary operations  ---------------------------------------------------
+  public:
+
     /// matrix vector product A*x
-    friend DenseVector operator*(DenseMatrix const& A, DenseVector const& x);
+    friend DenseVector operator*(CRSMatrix const& A, DenseVector const& x);
 
     /// computes the matrix-vector product, y = Ax.
     void mult(DenseVector const& x, DenseVector& y) const;
@@ -256,17 +868,20 @@ namespace scprog
     /// computes v3 = v2 + A * v1.
     void mult_add(DenseVector const& v1, DenseVector const& v2, DenseVector& v3) const;
 
-    /// computes Y = a*X + Y.
-    void axpy(value_type a, DenseMatrix const& X);
+    /// computes the matrix-vector product, y = Ax, and returns x^T*y in the same pass.
+    value_type mult_dot(DenseVector const& x, DenseVector& y) const;
 
-    /// computes Y = a*Y + X.
-    void aypx(value_type a, DenseMatrix const& X);
+    /// computes the product with a block of vectors, Y = AX, with the k vectors stored
+    /// interleaved as columns of the (cols x k) matrix X. The matrix is streamed once.
+    void mult(DenseMatrix const& X, DenseMatrix& Y) const;
 
 
   // ----- data members  -------------------------------------------------------
   private:
 
-    std::vector<value_type> data_;
+    index_array offsets_;
+    index_array indices_;
+    value_array values_;
     size_type rows_ = 0;
     size_type cols_ = 0;
   };
@@ -276,6 +891,195 @@ namespace scprog
   /// Results in a matrix A of size (m*n) x (m*n)
   void laplacian_setup(DenseMatrix& A, std::size_t m, std::size_t n);
 
+  /// Setup a sparse matrix according to a Laplacian equation on a 2D-grid using a
+  /// five-point-stencil. Results in a matrix A of size (m*n) x (m*n) with at most
+  /// five nonzeros per row.
+  void laplacian_setup(CRSMatrix& A, std::size_t m, std::size_t n);
+
+
+  /// A matrix-free operator applying the five-point-stencil of the Laplacian on a 2D-grid
+  /// of size m x n. Represents the same (m*n) x (m*n) matrix as \ref laplacian_setup, but
+  /// no matrix entries are stored.
+  class LaplacianOperator
+  {
+  public:
+    using size_type  = std::size_t;
+    using value_type = double;
+
+  public:
+
+    /// constructor of the operator on a grid with m x n points
+    LaplacianOperator(size_type m, size_type n)
+      : m_(m)
+      , n_(n)
+    {}
+
+    /// return the number of rows of the represented matrix
+    size_type rows() const
+    {
+      return m_*n_;
+    }
+
+    /// return the number of columns of the represented matrix
+    size_type cols() const
+    {
+      return m_*n_;
+    }
+
+    /// matrix-free operator application A*x
+    friend DenseVector operator*(LaplacianOperator const& A, DenseVector const& x);
+
+    /// computes the operator application, y = Ax.
+    void mult(DenseVector const& x, DenseVector& y) const;
+
+    /// computes v3 = v2 + A * v1.
+    void mult_add(DenseVector const& v1, DenseVector const& v2, DenseVector& v3) const;
+
+    /// computes the operator application, y = Ax, and returns x^T*y in the same pass.
+    value_type mult_dot(DenseVector const& x, DenseVector& y) const;
+
+    /// computes the operator application to a block of vectors, Y = AX, with the k
+    /// vectors stored interleaved as columns of the (cols x k) matrix X.
+    void mult(DenseMatrix const& X, DenseMatrix& Y) const;
+
+  private:
+    size_type m_;
+    size_type n_;
+  };
+
+
+  /// Recorder of the convergence history of an iterative solver
+  /**
+   * Stores the last `capacity` residuals with iteration number and time since construction
+   * (or \ref clear) in a ring buffer, and optionally calls a callback for each record. No
+   * output is performed during the solve; the history can be exported afterwards in CSV or
+   * JSON format. Attach to a \ref BasicIteration by `iter.set_telemetry(&telemetry)`.
+   **/
+  class IterationTelemetry
+  {
+  public:
+    using real_type = double;
+    using Clock     = std::chrono::steady_clock;
+
+    /// A single record of the convergence history
+    struct Entry
+    {
+      int iteration;
+      real_type resid;
+      double time;    // seconds since construction or last clear()
+    };
+
+    /// Callback called for each record with the new entry
+    using Callback = std::function<void(Entry const&)>;
+
+  public:
+    /// Constructor of a recorder keeping the last `capacity` entries
+    explicit IterationTelemetry(std::size_t capacity = 1024, Callback callback = {})
+      : buffer_(capacity)
+      , callback_(std::move(callback))
+      , t0_(Clock::now())
+    {
+      assert(capacity > 0);
+    }
+
+    /// Record the residual of the given iteration
+    void record(int iteration, real_type resid)
+    {
+      Entry entry{iteration, resid, std::chrono::duration<double>(Clock::now() - t0_).count()};
+      buffer_[(first_ + size_) % buffer_.size()] = entry;
+      if (size_ < buffer_.size())
+        ++size_;
+      else
+        first_ = (first_ + 1) % buffer_.size();
+      if (callback_)
+        callback_(entry);
+    }
+
+    /// Remove all entries and restart the clock
+    void clear()
+    {
+      first_ = size_ = 0;
+      t0_ = Clock::now();
+    }
+
+    /// Return the number of stored entries
+    std::size_t size() const { return size_; }
+
+    /// Return the i-th stored entry, starting with the oldest one
+    Entry const& operator[](std::size_t i) const
+    {
+      assert(i < size_);
+      return buffer_[(first_ + i) % buffer_.size()];
+    }
+
+    /// Write the history as CSV with a header line `iteration,resid,time`
+    void write_csv(std::ostream& out) const;
+
+    /// Write the history as JSON array of objects `{"iteration":..,"resid":..,"time":..}`,
+    /// with `null` for a residual that is not finite
+    void write_json(std::ostream& out) const;
+
+  private:
+    std::vector<Entry> buffer_;
+    std::size_t first_ = 0, size_ = 0;
+    Callback callback_;
+    Clock::time_point t0_;
+  };
+
+
+  /// The symmetric tridiagonal matrix T of the Lanczos process and its eigenvalues
+  /**
+   * T is the projection of a symmetric operator A onto a Krylov space. Its eigenvalues, the
+   * Ritz values, approximate the extreme eigenvalues of A from inside the spectrum after a
+   * few dozen steps. T is built either by \ref lanczos, or at no extra cost from the step
+   * lengths alpha and coefficients beta of \ref cg, by passing this object to the solver.
+   *
+   * The eigenvalues are computed by bisection with Sturm sequences, in O(k) operations per
+   * bisection step for a matrix of size k.
+   **/
+  class LanczosTridiagonal
+  {
+  public:
+    /// Append a row with diagonal entry a and the entry b coupling it to the previous row.
+    /// b is ignored for the first row.
+    void push_back(double a, double b);
+
+    /// Append the row of a cg iteration with step length alpha and the coefficient
+    /// beta = rho/rho_1 of the search direction update of that iteration, 0 in the first.
+    void add_cg_step(double alpha, double beta);
+
+    /// Remove all rows
+    void clear();
+
+    /// Return the number of rows
+    std::size_t size() const { return diag_.size(); }
+
+    /// Return the i-th diagonal entry
+    double diagonal(std::size_t i) const { assert(i < diag_.size()); return diag_[i]; }
+
+    /// Return the entry coupling the rows i and i+1
+    double offdiagonal(std::size_t i) const { assert(i < offdiag_.size()); return offdiag_[i]; }
+
+    /// Return the number of eigenvalues less than x
+    std::size_t count_below(double x) const;
+
+    /// Return the i-th smallest eigenvalue, i < size()
+    double eigenvalue(std::size_t i) const;
+
+    /// Return the smallest eigenvalue, an upper bound of the smallest eigenvalue of A
+    double min_eigenvalue() const { return eigenvalue(0); }
+
+    /// Return the largest eigenvalue, a lower bound of the largest eigenvalue of A
+    double max_eigenvalue() const { return eigenvalue(size() - 1); }
+
+    /// Return the estimate max_eigenvalue() / min_eigenvalue() of the condition number of A
+    double condition() const { return max_eigenvalue() / min_eigenvalue(); }
+
+  private:
+    std::vector<double> diag_, offdiag_;
+    double alpha_ = 0.0;  // step length of the previous cg iteration
+  };
+
 
   /// Basic utility class to control iterative solvers
   class BasicIteration
@@ -426,6 +1230,13 @@ namespace scprog
     /// Is final resume suppressed
     bool resume_suppressed() const { return suppress_; }
 
+    /// Record the residual of each call to \ref finished in the given telemetry object, or
+    /// disable recording with nullptr. The object must outlive the iteration.
+    void set_telemetry(IterationTelemetry* telemetry) { telemetry_ = telemetry; }
+
+    /// Attached telemetry object, or nullptr
+    IterationTelemetry* telemetry() const { return telemetry_; }
+
     void update_progress(BasicIteration const& that)
     {
       i_ = that.i_;
@@ -444,19 +1255,703 @@ namespace scprog
     real_type rtol_, atol_, resid_;
     std::string err_msg_;
     bool finished_ = false, quite_ = false, suppress_ = false, multi_print_ = false;
+    IterationTelemetry* telemetry_ = nullptr;
   };
 
 
+  /// Computes x += alpha*p and r -= alpha*q in a single pass and returns r^T*r
+  DenseVector::value_type cg_update(DenseVector::value_type alpha, DenseVector const& p,
+                                    DenseVector const& q, DenseVector& x, DenseVector& r);
+
+
   /// Apply the conjugate gradient algorithm to the linear system A*x = b and return an error code
   /**
-   * \param A  The system matrix
+   * \param A  The system matrix or operator, providing `A.mult(x, y)` to compute y = A*x
+   * \param x  The solution vector, e.g. a DenseVector or BasicDenseVector<float>. Must be of
+   *           correct size.
+   * \param b  The load vector of the linear system
+   * \param iter  An iteration object controlling number of iterations and break tolerances.
+   * \param spectrum  If not nullptr, the Lanczos matrix of A is built from the coefficients
+   *                  of the iteration, see \ref LanczosTridiagonal. Previous rows are removed.
+   *
+   * \return The error code of the \ref BasicIteration object. err=0 means no error.
+   **/
+  template <class Operator, class Vector>
+  int cg(Operator const& A, Vector& x, Vector const& b, BasicIteration& iter,
+         LanczosTridiagonal* spectrum = nullptr)
+  {
+    using std::abs;
+    using std::sqrt;
+    using Scalar = typename Vector::value_type;
+    using Real   = typename BasicIteration::real_type;
+
+    Scalar rho(0), rho_1(0), alpha(0);
+    Vector p(b), q(b);
+    Vector r(b.size());
+
+    A.mult(x, r);
+    r.aypx(Scalar(-1), b);  // r = b - A*x
+    if (spectrum)
+      spectrum->clear();
+
+    rho = r.unary_dot();
+    while (! iter.finished(Real(sqrt(abs(rho))))) {
+      ++iter;
+      if (iter.first())
+        p = r;
+      else
+        p.aypx(rho / rho_1, r); // p = r + (rho / rho_1) * p;
+
+      A.mult(p, q);           // q = A * p
+      alpha = rho / p.dot(q);
+      if (spectrum)
+        spectrum->add_cg_step(alpha, iter.first() ? Scalar(0) : rho / rho_1);
+
+      x.axpy(alpha, p);       // x += alpha * p
+      r.axpy(-alpha, q);      // r -= alpha * q
+
+      rho_1 = rho;
+      rho = r.unary_dot();    // rho = r^T * r
+    }
+
+    return iter;
+  }
+
+
+  /// Run k steps of the Lanczos process of the symmetric operator A with start vector v0
+  /**
+   * Only the last two Lanczos vectors are kept, i.e., there is no reorthogonalization. The
+   * extreme eigenvalues of T converge nevertheless, while interior eigenvalues may appear
+   * multiple times. The process stops early if the Krylov space becomes invariant.
+   *
+   * \param A   The symmetric operator, providing `A.mult(x, y)` to compute y = A*x
+   * \param v0  A nonzero start vector, e.g. a random vector
+   * \param k   The maximal number of steps, i.e., operator applications
+   * \param T   The resulting tridiagonal matrix, previous entries are removed
+   *
+   * \return The number of steps performed, the size of T.
+   **/
+  template <class Operator, class Vector>
+  std::size_t lanczos(Operator const& A, Vector const& v0, std::size_t k, LanczosTridiagonal& T)
+  {
+    using std::abs;
+    using Scalar = typename Vector::value_type;
+
+    T.clear();
+    Vector v(v0), v_1(v0.size(), Scalar(0)), w(v0.size());
+    v *= Scalar(1) / v.two_norm();
+
+    Scalar beta(0);
+    for (std::size_t j = 0; j < k; ++j) {
+      A.mult(v, w);           // w = A * v_j
+      Scalar alpha = w.dot(v);
+      T.push_back(alpha, beta);
+      if (j + 1 == k)
+        break;
+
+      w = w - alpha*v - beta*v_1;
+      beta = w.two_norm();
+      if (beta <= std::numeric_limits<Scalar>::epsilon() * abs(alpha))
+        break;                // invariant subspace, T holds exact eigenvalues of A
+
+      std::swap(v_1, v);
+      v = (Scalar(1) / beta) * w;
+    }
+
+    return T.size();
+  }
+
+
+  /// Apply the Chebyshev iteration to the linear system A*x = b and return an error code
+  /**
+   * The residual is damped by the Chebyshev polynomials of the interval [lmin, lmax], which
+   * must enclose the spectrum of the symmetric positive definite operator A. Unlike in
+   * \ref cg, the iteration coefficients are known in advance, so there are no inner products
+   * in the iteration. The norm of the recursively updated residual, a single reduction, is
+   * only computed every `check` iterations and passed to `iter`.
+   *
+   * The convergence rate (sqrt(k)-1)/(sqrt(k)+1), with k = lmax/lmin, is that of the worst
+   * case of \ref cg. Bounds can be estimated by \ref lanczos; lmax should then be enlarged
+   * by a small safety margin, since Ritz values lie inside the spectrum.
+   *
+   * \param A      The system matrix or operator, providing `A.mult(x, y)` to compute y = A*x
+   * \param lmin   A lower bound of the eigenvalues of A, lmin > 0
+   * \param lmax   An upper bound of the eigenvalues of A, lmax > lmin
+   * \param check  The number of iterations between two residual checks
+   *
+   * For the other parameters and the return value, see \ref cg.
+   **/
+  template <class Operator, class Vector>
+  int chebyshev(Operator const& A, Vector& x, Vector const& b, BasicIteration& iter,
+                double lmin, double lmax, int check = 10)
+  {
+    using Scalar = typename Vector::value_type;
+    using Real   = typename BasicIteration::real_type;
+
+    assert(0 < lmin && lmin < lmax);
+    assert(check >= 1);
+    Scalar const theta = (lmax + lmin) / 2, delta = (lmax - lmin) / 2;
+    Scalar const sigma = theta / delta;
+
+    Vector r(b.size()), d(b.size()), w(b.size());
+    A.mult(x, r);
+    r.aypx(Scalar(-1), b);    // r = b - A*x
+    d = (Scalar(1) / theta) * r;
+
+    Scalar rho = Scalar(1) / sigma;
+    Real resid = r.two_norm();
+    while (! iter.finished(resid)) {
+      for (int i = 0; i < check && iter.iterations() < iter.max_iterations(); ++i) {
+        ++iter;
+        A.mult(d, w);         // w = A * d
+        x += d;
+        r -= w;
+
+        Scalar rho_1 = Scalar(1) / (2*sigma - rho);
+        d = (rho_1*rho) * d + (2*rho_1/delta) * r;
+        rho = rho_1;
+      }
+      resid = r.two_norm();
+    }
+
+    return iter;
+  }
+
+
+  /// Apply `steps` Chebyshev iterations to A*x = b, improving the given x, without any
+  /// residual check
+  /**
+   * As a smoother, e.g. in multigrid, [lmin, lmax] is the upper part of the spectrum that
+   * is to be damped, typically [lmax/30, 1.1*lmax] with an estimate lmax of the largest
+   * eigenvalue. The result is a fixed polynomial in A, i.e., a linear symmetric operation.
+   *
+   * For the parameters, see \ref chebyshev.
+   **/
+  template <class Operator, class Vector>
+  void chebyshev_smooth(Operator const& A, Vector& x, Vector const& b, int steps,
+                        double lmin, double lmax)
+  {
+    using Scalar = typename Vector::value_type;
+
+    assert(0 < lmin && lmin < lmax);
+    Scalar const theta = (lmax + lmin) / 2, delta = (lmax - lmin) / 2;
+    Scalar const sigma = theta / delta;
+
+    Vector r(b.size()), d(b.size()), w(b.size());
+    A.mult(x, r);
+    r.aypx(Scalar(-1), b);    // r = b - A*x
+    d = (Scalar(1) / theta) * r;
+
+    Scalar rho = Scalar(1) / sigma;
+    for (int i = 0; i < steps; ++i) {
+      x += d;
+      if (i + 1 == steps)
+        break;
+      A.mult(d, w);           // w = A * d
+      r -= w;
+
+      Scalar rho_1 = Scalar(1) / (2*sigma - rho);
+      d = (rho_1*rho) * d + (2*rho_1/delta) * r;
+      rho = rho_1;
+    }
+  }
+
+
+  /// Apply the preconditioned conjugate gradient algorithm to the linear system A*x = b
+  /**
+   * \param A  The system matrix or operator, providing `A.mult(x, y)` to compute y = A*x
    * \param x  The solution vector. Must be of correct size.
    * \param b  The load vector of the linear system
+   * \param P  A symmetric positive definite preconditioner, providing `P.apply(r, z)` to
+   *           compute z = P^{-1} r, e.g., one of the preconditioners in preconditioner.hh
    * \param iter  An iteration object controlling number of iterations and break tolerances.
+   *              The tolerances refer to the unpreconditioned residual |b - A*x|.
    *
    * \return The error code of the \ref BasicIteration object. err=0 means no error.
    **/
-  int cg(DenseMatrix const& A, DenseVector& x, DenseVector const& b, BasicIteration& iter);
+  template <class Operator, class Preconditioner>
+  int pcg(Operator const& A, DenseVector& x, DenseVector const& b, Preconditioner const& P,
+          BasicIteration& iter)
+  {
+    using std::abs;
+    using std::sqrt;
+    using Vector = DenseVector;
+    using Scalar = typename DenseVector::value_type;
+    using Real   = typename BasicIteration::real_type;
+
+    Scalar rho(0), rho_1(0), alpha(0);
+    Vector p(b), q(b), z(b);
+    Vector r(b.size());
+
+    A.mult(x, r);
+    r.aypx(Scalar(-1), b);  // r = b - A*x
+
+    Real resid = r.two_norm();
+    while (! iter.finished(resid)) {
+      ++iter;
+      P.apply(r, z);          // z = P^{-1} r
+      rho = r.dot(z);
+      if (iter.first())
+        p = z;
+      else
+        p.aypx(rho / rho_1, z); // p = z + (rho / rho_1) * p;
+
+      A.mult(p, q);           // q = A * p
+      alpha = rho / p.dot(q);
+
+      // x += alpha * p, r -= alpha * q, resid = |r|
+      resid = Real(sqrt(abs(cg_update(alpha, p, q, x, r))));
+      rho_1 = rho;
+    }
+
+    return iter;
+  }
+
+
+  /// Computes the inner products d_j = X_j^T*Y_j of all columns j of the blocks of vectors X and Y
+  void column_dots(DenseMatrix const& X, DenseMatrix const& Y, DenseVector& d);
+
+  /// Computes X_j += alpha_j*P_j and R_j -= alpha_j*Q_j for all columns j in a single pass
+  /// and returns rho_j = R_j^T*R_j
+  void cg_block_update(DenseVector const& alpha, DenseMatrix const& P, DenseMatrix const& Q,
+                       DenseMatrix& X, DenseMatrix& R, DenseVector& rho);
+
+  /// Computes P_j = R_j + beta_j*P_j for all columns j
+  void block_aypx(DenseVector const& beta, DenseMatrix& P, DenseMatrix const& R);
+
+
+  /// Apply the conjugate gradient algorithm to the linear systems A*X_j = B_j for k right-hand sides
+  /**
+   * All right-hand sides are advanced together, such that each iteration applies the
+   * operator only once to the whole block. The blocks are stored interleaved, as rows of
+   * a (n x k) \ref DenseMatrix, i.e., the k entries of each unknown are contiguous.
+   *
+   * \param A      The system matrix or operator, providing `A.mult(X, Y)` for blocks
+   * \param X      The block of solution vectors. Must be of size (n x k).
+   * \param B      The block of load vectors, of size (n x k)
+   * \param iters  One iteration object per right-hand side. A column is frozen once its
+   *               iteration object is finished.
+   *
+   * \return The first nonzero error code of the \ref BasicIteration objects, or 0.
+   **/
+  template <class Operator>
+  int cg_block(Operator const& A, DenseMatrix& X, DenseMatrix const& B, std::vector<BasicIteration>& iters)
+  {
+    using std::abs;
+    using std::sqrt;
+    using Scalar = typename DenseVector::value_type;
+    using Real   = typename BasicIteration::real_type;
+
+    std::size_t const k = B.cols();
+    assert(iters.size() == k);
+    assert(X.rows() == B.rows() && X.cols() == k);
+
+    DenseVector rho(k), rho_1(k), alpha(k), beta(k), pq(k);
+    DenseMatrix P(B.rows(), k), Q(B.rows(), k), R(B.rows(), k);
+
+    A.mult(X, R);
+    R.aypx(Scalar(-1), B);  // R = B - A*X
+    column_dots(R, R, rho);
+
+    auto active = [&](std::size_t j) { return !iters[j].finished(); };
+    bool finished = true;
+    for (std::size_t j = 0; j < k; ++j)
+      finished = iters[j].finished(Real(sqrt(abs(rho[j])))) && finished;
+
+    while (! finished) {
+      for (std::size_t j = 0; j < k; ++j) {
+        if (active(j)) {
+          ++iters[j];
+          beta[j] = iters[j].first() ? Scalar(0) : rho[j] / rho_1[j];
+        } else {
+          beta[j] = Scalar(0);
+        }
+      }
+      block_aypx(beta, P, R);   // P_j = R_j + beta_j * P_j
+
+      A.mult(P, Q);             // Q = A * P
+      column_dots(P, Q, pq);
+      for (std::size_t j = 0; j < k; ++j)
+        alpha[j] = active(j) ? rho[j] / pq[j] : Scalar(0);
+
+      rho_1 = rho;
+      cg_block_update(alpha, P, Q, X, R, rho);
+
+      finished = true;
+      for (std::size_t j = 0; j < k; ++j)
+        if (active(j))
+          finished = iters[j].finished(Real(sqrt(abs(rho[j])))) && finished;
+    }
+
+    int err = 0;
+    for (auto const& iter : iters) {
+      int e = iter.error_code();
+      err = err ? err : e;
+    }
+    return err;
+  }
+
+
+  /// Apply the conjugate gradient algorithm with fused kernels to the linear system A*x = b
+  /**
+   * Same algorithm as \ref cg, but q = A*p is computed together with p^T*q, and the updates
+   * of x and r are computed together with r^T*r, see \ref cg_update. This reduces the number
+   * of passes over memory per iteration from six to three. No vectors are allocated inside
+   * the iteration.
+   *
+   * \param A  The system matrix or operator, providing `A.mult_dot(x, y)` to compute y = A*x
+   *           and return x^T*y.
+   *
+   * For the other parameters and the return value, see \ref cg.
+   **/
+  template <class Operator>
+  int cg_fused(Operator const& A, DenseVector& x, DenseVector const& b, BasicIteration& iter)
+  {
+    using std::abs;
+    using std::sqrt;
+    using Vector = DenseVector;
+    using Scalar = typename DenseVector::value_type;
+    using Real   = typename BasicIteration::real_type;
+
+    Scalar rho(0), rho_1(0), alpha(0);
+    Vector p(b), q(b);
+    Vector r(b.size());
+
+    A.mult(x, r);
+    r.aypx(Scalar(-1), b);  // r = b - A*x
+
+    rho = r.unary_dot();
+    while (! iter.finished(Real(sqrt(abs(rho))))) {
+      ++iter;
+      if (iter.first())
+        p = r;
+      else
+        p.aypx(rho / rho_1, r); // p = r + (rho / rho_1) * p;
+
+      alpha = rho / A.mult_dot(p, q);         // q = A * p, alpha = rho / p^T*q
+
+      rho_1 = rho;
+      rho = cg_update(alpha, p, q, x, r);     // x += alpha * p, r -= alpha * q, rho = r^T * r
+    }
+
+    return iter;
+  }
+
+
+  /// Computes the Gram matrix G = V^T*V of the basis vectors V_0,...,V_{m-1} in a single pass
+  /// over the vectors, with one reduction for all m*m inner products
+  void gram_matrix(std::vector<DenseVector> const& V, DenseMatrix& G);
+
+  /// Computes the linear combination y = sum_a c_a*V_a of the basis vectors
+  void basis_mult(std::vector<DenseVector> const& V, std::vector<double> const& c, DenseVector& y);
+
+  /// Computes y += sum_a c_a*V_a
+  void basis_mult_add(std::vector<DenseVector> const& V, std::vector<double> const& c,
+                      DenseVector& y);
+
+
+  /// Apply the communication-avoiding s-step conjugate gradient algorithm to the linear
+  /// system A*x = b
+  /**
+   * Every s iterations, the Krylov bases of the current search direction p and residual r,
+   * V = [p, ..., T_s(A)p, r, ..., T_{s-1}(A)r], are computed by 2s-1 operator applications
+   * and their Gram matrix G = V^T*V by a single block reduction, see \ref gram_matrix. The s
+   * iterations of \ref cg are then performed on the coordinates with respect to V, with
+   * inner products evaluated by G, and x, r and p are recovered from their coordinates.
+   * Thus, there is one global reduction per s iterations instead of two per iteration.
+   *
+   * The bases use the Chebyshev polynomials T_j, shifted and scaled to the interval
+   * [lmin, lmax], which should enclose the spectrum of A. The condition of these bases grows
+   * much slower with s than that of the monomial basis [p, Ap, ..., A^s p]. Nevertheless,
+   * the residual is a recursively updated one, and for larger s or rough eigenvalue bounds
+   * the attainable accuracy and the convergence rate are lower than for \ref cg.
+   *
+   * \param A  The symmetric positive definite operator, providing `A.mult(x, y)`
+   * \param s  The number of iterations per basis, s >= 1. Typically 2 to 8.
+   * \param lmin  A lower bound of the eigenvalues of A
+   * \param lmax  An upper bound of the eigenvalues of A, lmax > lmin
+   *
+   * The residual norm passed to `iter` is evaluated from the Gram matrix in every
+   * iteration. For the other parameters and the return value, see \ref cg.
+   **/
+  template <class Operator>
+  int cg_sstep(Operator const& A, DenseVector& x, DenseVector const& b, BasicIteration& iter,
+               std::size_t s, double lmin, double lmax)
+  {
+    using std::abs;
+    using std::sqrt;
+    using Vector = DenseVector;
+    using Scalar = typename DenseVector::value_type;
+    using Real   = typename BasicIteration::real_type;
+
+    assert(s >= 1);
+    assert(lmax > lmin);
+    std::size_t const m = 2*s + 1;   // columns [0, s] span the p-basis, [s+1, 2s] the r-basis
+
+    // V[0] and V[s+1] hold the current search direction p and the residual r
+    std::vector<Vector> V;
+    V.reserve(m);
+    for (std::size_t j = 0; j < m; ++j)
+      V.emplace_back(b.size());
+    Vector& p = V[0];
+    Vector& r = V[s+1];
+    A.mult(x, r);
+    r.aypx(Scalar(-1), b);  // r = b - A*x
+    p = r;
+
+    // three-term recurrence of the Chebyshev basis: A V_j = c V_j + d/2 (V_{j+1} + V_{j-1})
+    // with A V_0 = c V_0 + d V_1. T is the matrix of this recurrence, A V_j = sum_i T_ij V_i
+    Scalar const c = (lmax + lmin) / 2, d = (lmax - lmin) / 2;
+    DenseMatrix T(m, m, Scalar(0));
+    for (std::size_t first : {std::size_t(0), s+1}) {
+      std::size_t const last = first == 0 ? s : 2*s;   // the last basis vector is not applied
+      for (std::size_t j = first; j < last; ++j) {
+        T(j, j) = c;
+        T(j+1, j) = j == first ? d : d/2;
+        if (j > first)
+          T(j-1, j) = d/2;
+      }
+    }
+
+    auto chebyshev_basis = [&](std::size_t first, std::size_t last) {
+      for (std::size_t j = first; j < last; ++j) {
+        A.mult(V[j], V[j+1]);
+        if (j == first)
+          V[j+1] = (Scalar(1)/d) * (V[j+1] - c*V[j]);
+        else
+          V[j+1] = (Scalar(2)/d) * (V[j+1] - c*V[j]) - V[j-1];
+      }
+    };
+
+    // the products of the coordinates have size m and run serially on the calling thread,
+    // such that the Gram matrix is the only synchronization point per s iterations
+    auto coord_mult = [m](DenseMatrix const& M, std::vector<Scalar> const& u,
+                          std::vector<Scalar>& v) {
+      for (std::size_t i = 0; i < m; ++i) {
+        Scalar sum = 0;
+        for (std::size_t j = 0; j < m; ++j)
+          sum += M(i,j) * u[j];
+        v[i] = sum;
+      }
+    };
+    auto coord_dot = [m](std::vector<Scalar> const& u, std::vector<Scalar> const& v) {
+      Scalar sum = 0;
+      for (std::size_t i = 0; i < m; ++i)
+        sum += u[i] * v[i];
+      return sum;
+    };
+
+    DenseMatrix G(m, m);
+    std::vector<Scalar> pc(m), rc(m), xc(m), w(m), Gv(m);
+    Vector rn(b.size()), pn(b.size());
+
+    Real resid = r.two_norm();
+    bool finished = iter.finished(resid);
+    while (! finished) {
+      chebyshev_basis(0, s);
+      chebyshev_basis(s+1, 2*s);
+      gram_matrix(V, G);
+
+      // coordinates of p, r and the update of x with respect to the basis V
+      std::fill(pc.begin(), pc.end(), Scalar(0)); pc[0] = Scalar(1);
+      std::fill(rc.begin(), rc.end(), Scalar(0)); rc[s+1] = Scalar(1);
+      std::fill(xc.begin(), xc.end(), Scalar(0));
+
+      coord_mult(G, rc, Gv);
+      Scalar rho = coord_dot(rc, Gv);   // rho = r^T * r
+      for (std::size_t j = 0; j < s && !finished; ++j) {
+        ++iter;
+        coord_mult(T, pc, w);           // w = coordinates of A * p
+        coord_mult(G, w, Gv);
+        Scalar alpha = rho / coord_dot(pc, Gv);
+
+        Scalar rho_1 = rho;
+        for (std::size_t i = 0; i < m; ++i) {
+          xc[i] += alpha * pc[i];       // x += alpha * p
+          rc[i] -= alpha * w[i];        // r -= alpha * A * p
+        }
+
+        coord_mult(G, rc, Gv);
+        rho = coord_dot(rc, Gv);        // rho = r^T * r
+        for (std::size_t i = 0; i < m; ++i)
+          pc[i] = rc[i] + (rho / rho_1) * pc[i];   // p = r + (rho / rho_1) * p
+
+        finished = iter.finished(Real(sqrt(abs(rho))));
+      }
+
+      basis_mult_add(V, xc, x);  // x += V * xc
+      if (! finished) {
+        basis_mult(V, rc, rn);   // r = V * rc
+        basis_mult(V, pc, pn);   // p = V * pc
+        std::swap(r, rn);
+        std::swap(p, pn);
+      }
+    }
+
+    return iter;
+  }
+
+
+  /// Apply the stabilized biconjugate gradient algorithm (BiCGStab) to the linear system
+  /// A*x = b and return an error code
+  /**
+   * Solves systems with nonsymmetric operators. Each iteration applies the operator twice
+   * and needs five global reductions. All vectors are allocated before the iteration.
+   *
+   * \param A  The system matrix or operator, providing `A.mult(x, y)` to compute y = A*x
+   *
+   * For the other parameters, see \ref cg.
+   *
+   * \return The error code of the \ref BasicIteration object, or 2 on a breakdown of the
+   *         biorthogonalization (rho = 0) and 3 on a breakdown of the stabilization
+   *         (omega = 0).
+   **/
+  template <class Operator, class Vector>
+  int bicgstab(Operator const& A, Vector& x, Vector const& b, BasicIteration& iter)
+  {
+    using std::abs;
+    using Scalar = typename Vector::value_type;
+    using Real   = typename BasicIteration::real_type;
+
+    Scalar rho(1), rho_1(1), alpha(1), omega(1);
+    Vector p(b.size()), v(b.size()), t(b.size());
+    Vector r(b.size());
+
+    A.mult(x, r);
+    r.aypx(Scalar(-1), b);  // r = b - A*x
+    Vector const r0(r);     // shadow residual
+
+    Real resid = r.two_norm();
+    while (! iter.finished(resid)) {
+      ++iter;
+      rho_1 = rho;
+      rho = r0.dot(r);
+      if (rho == Scalar(0))
+        return iter.fail(2, "BiCGStab breakdown: rho = 0");
+
+      if (iter.first())
+        p = r;
+      else
+        p = r + ((rho / rho_1) * (alpha / omega)) * (p - omega*v);
+
+      A.mult(p, v);           // v = A * p
+      alpha = rho / r0.dot(v);
+      r.axpy(-alpha, v);      // s = r - alpha * v, stored in r
+
+      A.mult(r, t);           // t = A * s
+      Scalar tt = t.unary_dot();
+      omega = tt == Scalar(0) ? Scalar(0) : t.dot(r) / tt;
+
+      x += alpha*p + omega*r; // x += alpha * p + omega * s
+      r.axpy(-omega, t);      // r = s - omega * t
+
+      resid = r.two_norm();
+      if (omega == Scalar(0) && resid > iter.atol() && resid > iter.rtol() * iter.norm_r0())
+        return iter.fail(3, "BiCGStab breakdown: omega = 0");
+    }
+
+    return iter;
+  }
+
+
+  /// Apply the restarted generalized minimal residual algorithm, GMRES(m), to the linear
+  /// system A*x = b and return an error code
+  /**
+   * Solves systems with nonsymmetric operators. An orthonormal basis of the Krylov space of
+   * dimension m is built by modified Gram-Schmidt, and the least-squares problem of the
+   * upper Hessenberg matrix is solved by Givens rotations. The residual norm is obtained
+   * from the rotations in every iteration without an extra reduction. After m iterations,
+   * the solution is updated, the true residual is computed, and the iteration is restarted.
+   *
+   * The basis of m+1 vectors is allocated once before the iteration.
+   *
+   * \param A  The system matrix or operator, providing `A.mult(x, y)` to compute y = A*x
+   * \param m  The restart length, i.e., the maximal dimension of the Krylov space
+   *
+   * For the other parameters and the return value, see \ref cg.
+   **/
+  template <class Operator, class Vector>
+  int gmres(Operator const& A, Vector& x, Vector const& b, BasicIteration& iter,
+            std::size_t m = 30)
+  {
+    using std::abs;
+    using std::sqrt;
+    using Scalar = typename Vector::value_type;
+    using Real   = typename BasicIteration::real_type;
+
+    assert(m >= 1);
+    std::vector<Vector> V;
+    V.reserve(m + 1);
+    for (std::size_t j = 0; j <= m; ++j)
+      V.emplace_back(b.size());
+
+    // the upper Hessenberg matrix, column-wise, the Givens rotations and the rotated rhs
+    std::vector<Scalar> H((m + 1) * m), cs(m), sn(m), g(m + 1), y(m);
+    auto h = [&H,m](std::size_t i, std::size_t j) -> Scalar& { return H[j*(m + 1) + i]; };
+
+    Vector& r = V[0];
+    A.mult(x, r);
+    r.aypx(Scalar(-1), b);  // r = b - A*x
+
+    Real beta = r.two_norm();
+    while (! iter.finished(beta)) {
+      r *= Scalar(1 / beta);  // V_0 = r / |r|
+      std::fill(g.begin(), g.end(), Scalar(0));
+      g[0] = Scalar(beta);
+
+      std::size_t k = 0;      // dimension of the Krylov space
+      bool finished = false;
+      while (k < m && !finished) {
+        std::size_t const j = k++;
+        ++iter;
+        A.mult(V[j], V[j+1]); // w = A * V_j
+        for (std::size_t i = 0; i <= j; ++i) {
+          h(i,j) = V[j+1].dot(V[i]);
+          V[j+1].axpy(-h(i,j), V[i]);
+        }
+        h(j+1,j) = V[j+1].two_norm();
+        if (h(j+1,j) != Scalar(0))
+          V[j+1] *= Scalar(1) / h(j+1,j);
+
+        // apply the previous rotations to the new column and eliminate h(j+1,j)
+        for (std::size_t i = 0; i < j; ++i) {
+          Scalar tmp = cs[i]*h(i,j) + sn[i]*h(i+1,j);
+          h(i+1,j) = -sn[i]*h(i,j) + cs[i]*h(i+1,j);
+          h(i,j) = tmp;
+        }
+        Scalar nu = sqrt(h(j,j)*h(j,j) + h(j+1,j)*h(j+1,j));
+        cs[j] = nu == Scalar(0) ? Scalar(1) : h(j,j) / nu;
+        sn[j] = nu == Scalar(0) ? Scalar(0) : h(j+1,j) / nu;
+        h(j,j) = nu;
+        h(j+1,j) = Scalar(0);
+        g[j+1] = -sn[j]*g[j];
+        g[j] = cs[j]*g[j];
+
+        // the last iteration of a cycle is checked with the true residual after the restart
+        if (k < m)
+          finished = iter.finished(Real(abs(g[k])));
+      }
+
+      // solve the triangular system H y = g and update x += V y
+      for (std::size_t i = k; i-- > 0;) {
+        Scalar sum = g[i];
+        for (std::size_t l = i+1; l < k; ++l)
+          sum -= h(i,l) * y[l];
+        y[i] = sum / h(i,i);
+      }
+      for (std::size_t i = 0; i < k; ++i)
+        x.axpy(y[i], V[i]);
+
+      if (finished)
+        break;
+
+      A.mult(x, r);
+      r.aypx(Scalar(-1), b);  // r = b - A*x
+      beta = r.two_norm();
+    }
+
+    return iter;
+  }
 
 
 } // end namespace scprog
\ No newline at end of file
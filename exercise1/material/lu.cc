@@ -0,0 +1,59 @@
+#include <cassert>
+#include <cmath>
+
+#include "lu.hh"
+
+namespace scprog {
+
+// decomposing the matrix A, without modifying it
+template <class T>
+void BasicLU<T>::compute(BasicDenseMatrix<T> const& A)
+{
+  assert(A.rows() == A.cols());
+  std::size_t n = A.rows();
+
+  // copy-assign the input matrix to the decomposition
+  decomposition_ = A;
+
+  for (std::size_t i = 0; i+1 < n; ++i) {
+    for (std::size_t k = i+1; k < n; ++k) {
+      assert(std::abs(decomposition_(i,i)) > 1.e-10);
+      decomposition_(k,i) = decomposition_(k,i) / decomposition_(i,i);
+      for (std::size_t j = i+1; j < n; ++j)
+        decomposition_(k,j) -= decomposition_(k,i) * decomposition_(i,j);
+    }
+  }
+}
+
+
+// solve the linear system A*x = b using the decomposed matrix
+template <class T>
+void BasicLU<T>::apply(BasicDenseVector<T> const& b, BasicDenseVector<T>& x) const
+{
+  assert(decomposition_.rows() == x.size());
+  assert(decomposition_.cols() == b.size());
+
+  // forward elimination, x = L^{-1} b
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    value_type f = 0;
+    for (std::size_t k = 0; k < i; ++k)
+      f += decomposition_(i,k) * x[k];
+    x[i] = b[i] - f;
+  }
+
+  // backward elimination, x = U^{-1} x
+  for (std::size_t j = 0; j < x.size(); ++j) {
+    std::size_t i = x.size()-j-1;
+    value_type f = 0;
+    for (std::size_t k = i+1; k < x.size(); ++k)
+      f += decomposition_(i,k) * x[k];
+    x[i] = (x[i] - f)/decomposition_(i,i);
+  }
+}
+
+
+// explicit instantiation for the element types used by the solvers
+template class BasicLU<double>;
+template class BasicLU<float>;
+
+} // end namespace scprog
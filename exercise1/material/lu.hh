@@ -0,0 +1,33 @@
+#pragma once
+
+#include "linear_algebra.hh"
+
+namespace scprog
+{
+  /// Direct solver based on an LU decomposition (without pivoting) of a dense matrix
+  /**
+   * \tparam T  The element type of the decomposition, e.g. double or float
+   **/
+  template <class T>
+  class BasicLU
+  {
+  public:
+    using value_type = T;
+
+    /// decomposing the matrix A, without modifying it
+    void compute(BasicDenseMatrix<T> const& A);
+
+    /// solve the linear system A*x = b using the decomposed matrix
+    void apply(BasicDenseVector<T> const& b, BasicDenseVector<T>& x) const;
+
+  private:
+    BasicDenseMatrix<T> decomposition_; // store the decomposition in this matrix
+  };
+
+  /// The LU decomposition in double precision
+  using LU = BasicLU<double>;
+
+  extern template class BasicLU<double>;
+  extern template class BasicLU<float>;
+
+} // end namespace scprog
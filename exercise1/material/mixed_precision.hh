@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cassert>
+
+#include "linear_algebra.hh"
+
+namespace scprog
+{
+  /// Copy the entries of the vector x into y, converting to the element type of y
+  template <class S, class T>
+  void convert(BasicDenseVector<S> const& x, BasicDenseVector<T>& y)
+  {
+    y.resize(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i)
+      y[i] = T(x[i]);
+  }
+
+  /// Copy the entries of the matrix A into B, converting to the element type of B
+  template <class S, class T>
+  void convert(BasicDenseMatrix<S> const& A, BasicDenseMatrix<T>& B)
+  {
+    B.resize(A.rows(), A.cols());
+    for (std::size_t r = 0; r < A.rows(); ++r)
+      for (std::size_t c = 0; c < A.cols(); ++c)
+        B(r,c) = T(A(r,c));
+  }
+
+
+  /// Approximate solver of A*d = r by a few conjugate gradient iterations, used as the
+  /// low-precision inner solver of \ref iterative_refinement
+  /**
+   * \tparam Operator  The matrix type in low precision, e.g. BasicDenseMatrix<float>
+   **/
+  template <class Operator>
+  class CGInnerSolver
+  {
+  public:
+    using value_type = typename Operator::value_type;
+
+    /// constructor with the operator, the relative reduction of the residual to reach and
+    /// the maximal number of iterations per solve
+    explicit CGInnerSolver(Operator const& A, double rtol = 1.e-3, int max_iter = 1000)
+      : A_(A)
+      , rtol_(rtol)
+      , max_iter_(max_iter)
+    {}
+
+    /// solve approximately A*d = r, starting from d = 0
+    void apply(BasicDenseVector<value_type> const& r, BasicDenseVector<value_type>& d) const
+    {
+      d.resize(r.size());
+      d = value_type(0);
+      BasicIteration iter(r, max_iter_, rtol_);
+      iter.set_quite(true);
+      iter.suppress_resume(true);
+      cg(A_, d, r, iter);
+    }
+
+  private:
+    Operator const& A_;
+    double rtol_;
+    int max_iter_;
+  };
+
+
+  /// Solve the linear system A*x = b by iterative refinement with a low-precision inner solver
+  /**
+   * Residuals r = b - A*x and the updates x += d are computed in double precision, while
+   * the correction equations A*d = r are solved in the precision of the inner solver, e.g.,
+   * by a float LU decomposition or float cg. The residual is scaled by its maximum norm
+   * before the conversion to avoid underflow of the small residuals of late iterations.
+   *
+   * \param A  The system matrix in double precision, providing `A.mult(x, y)`
+   * \param x  The solution vector. Must be of correct size.
+   * \param b  The load vector of the linear system
+   * \param inner  The low-precision solver, providing `inner.apply(r, d)` to compute
+   *               d ~= A^{-1} r, e.g. BasicLU<float> or CGInnerSolver
+   * \param iter  An iteration object controlling number of refinement steps and break
+   *              tolerances, checked on the double-precision residual.
+   *
+   * \return The error code of the \ref BasicIteration object. err=0 means no error.
+   **/
+  template <class Operator, class InnerSolver>
+  int iterative_refinement(Operator const& A, DenseVector& x, DenseVector const& b,
+                           InnerSolver const& inner, BasicIteration& iter)
+  {
+    using Real = typename BasicIteration::real_type;
+    using T    = typename InnerSolver::value_type;
+
+    DenseVector r(b.size()), d(b.size());
+    BasicDenseVector<T> r_low(b.size()), d_low(b.size());
+
+    A.mult(x, r);
+    r.aypx(-1.0, b);              // r = b - A*x
+
+    while (! iter.finished(Real(r.two_norm()))) {
+      ++iter;
+      Real scale = r.inf_norm();
+      r *= 1.0 / scale;
+      convert(r, r_low);
+      inner.apply(r_low, d_low);  // d = A^{-1} r in low precision
+      convert(d_low, d);
+      x.axpy(scale, d);           // x += scale * d
+
+      A.mult(x, r);
+      r.aypx(-1.0, b);            // r = b - A*x
+    }
+
+    return iter;
+  }
+
+} // end namespace scprog
@@ -0,0 +1,168 @@
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include "multigrid.hh"
+
+namespace scprog {
+
+// build the grid hierarchy and factorize the coarse grid matrix
+GeometricMultigrid::GeometricMultigrid(size_type m, size_type n, int gamma, int nu1, int nu2,
+                                       size_type coarse_size, value_type omega)
+  : gamma_(gamma)
+  , nu1_(nu1)
+  , nu2_(nu2)
+  , omega_(omega)
+{
+  assert(m > 0 && n > 0);
+  assert(gamma >= 1);
+
+  value_type scale = 1;
+  while (true) {
+    levels_.push_back(Level{m, n, scale, DenseVector(m*n), DenseVector(m*n), DenseVector(m*n)});
+    if (m*n <= coarse_size || m < 3 || n < 3)
+      break;
+    m = (m-1)/2;
+    n = (n-1)/2;
+    scale /= 4;
+  }
+
+  Level const& coarse = levels_.back();
+  if (coarse.m * coarse.n > coarse_size)
+    throw std::invalid_argument("The grid cannot be coarsened to at most "
+      + std::to_string(coarse_size) + " unknowns, the coarsest grid has size "
+      + std::to_string(coarse.m) + "x" + std::to_string(coarse.n));
+
+  DenseMatrix A;
+  laplacian_setup(A, coarse.m, coarse.n);
+  for (size_type i = 0; i < A.rows(); ++i)
+    for (size_type j = 0; j < A.cols(); ++j)
+      A(i,j) *= coarse.scale;
+  coarse_solver_.compute(A);
+}
+
+
+// apply one cycle with initial guess z = 0 to the system A*z = r
+void GeometricMultigrid::apply(DenseVector const& r, DenseVector& z) const
+{
+  z = 0;
+  cycle(z, r);
+}
+
+
+// apply one cycle to the system A*x = b, improving the given x
+void GeometricMultigrid::cycle(DenseVector& x, DenseVector const& b) const
+{
+  Level const& fine = levels_.front();
+  assert(x.size() == fine.m * fine.n);
+  assert(b.size() == fine.m * fine.n);
+  fine.x = x;
+  fine.b = b;
+  cycle(0);
+  x = fine.x;
+}
+
+
+// recursive cycle on level l
+void GeometricMultigrid::cycle(size_type l) const
+{
+  Level const& level = levels_[l];
+  if (l+1 == levels_.size()) {
+    coarse_solver_.apply(level.b, level.x);
+    return;
+  }
+
+  smooth(l, nu1_);
+  residual(l);
+  restrict_residual(l);
+
+  levels_[l+1].x = 0;
+  for (int i = 0; i < gamma_; ++i)
+    cycle(l+1);
+
+  prolongate_add(l);
+  smooth(l, nu2_);
+}
+
+
+// damped Jacobi smoothing steps: x += omega * D^{-1} (b - A*x)
+void GeometricMultigrid::smooth(size_type l, int steps) const
+{
+  Level const& level = levels_[l];
+  for (int i = 0; i < steps; ++i) {
+    residual(l);
+    level.x.axpy(omega_ / (4 * level.scale), level.r);
+  }
+}
+
+
+// residual r = b - A*x
+void GeometricMultigrid::residual(size_type l) const
+{
+  Level const& level = levels_[l];
+  LaplacianOperator(level.m, level.n).mult(level.x, level.r);
+  level.r.aypx(-level.scale, level.b);
+}
+
+
+// full-weighting restriction: the coarse point (I,J) coincides with the fine point (2I+1,2J+1)
+void GeometricMultigrid::restrict_residual(size_type l) const
+{
+  Level const& fine = levels_[l];
+  Level const& coarse = levels_[l+1];
+  DenseVector const& r = fine.r;
+  size_type const n = fine.n;
+
+  for (size_type I = 0; I < coarse.m; ++I) {
+    for (size_type J = 0; J < coarse.n; ++J) {
+      size_type c = (2*I+1) * n + (2*J+1);
+      coarse.b[I * coarse.n + J] =
+        ( 4 * r[c]
+        + 2 * (r[c-1] + r[c+1] + r[c-n] + r[c+n])
+        +     (r[c-n-1] + r[c-n+1] + r[c+n-1] + r[c+n+1]) ) / 16;
+    }
+  }
+}
+
+
+// bilinear prolongation, the transposed of the restriction scaled by 4
+void GeometricMultigrid::prolongate_add(size_type l) const
+{
+  Level const& fine = levels_[l];
+  Level const& coarse = levels_[l+1];
+  DenseVector& x = fine.x;
+  size_type const n = fine.n;
+
+  for (size_type I = 0; I < coarse.m; ++I) {
+    for (size_type J = 0; J < coarse.n; ++J) {
+      value_type e = coarse.x[I * coarse.n + J];
+      size_type c = (2*I+1) * n + (2*J+1);
+      x[c] += e;
+      x[c-1] += e/2;   x[c+1] += e/2;   x[c-n] += e/2;   x[c+n] += e/2;
+      x[c-n-1] += e/4; x[c-n+1] += e/4; x[c+n-1] += e/4; x[c+n+1] += e/4;
+    }
+  }
+}
+
+
+// Apply multigrid cycles to the linear system A*x = b
+int multigrid(GeometricMultigrid const& mg, DenseVector& x, DenseVector const& b, BasicIteration& iter)
+{
+  assert(x.size() == mg.rows());
+  assert(b.size() == mg.rows());
+
+  LaplacianOperator A = mg.op();
+  DenseVector r(b.size());
+  A.mult(x, r);
+  r.aypx(-1, b);  // r = b - A*x
+
+  while (! iter.finished(r)) {
+    ++iter;
+    mg.cycle(x, b);
+    A.mult(x, r);
+    r.aypx(-1, b);
+  }
+
+  return iter;
+}
+
+} // end namespace scprog
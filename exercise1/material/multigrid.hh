@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+
+#include "linear_algebra.hh"
+#include "lu.hh"
+
+namespace scprog
+{
+  /// Geometric multigrid for the five-point Laplacian on a 2D-grid of size m x n
+  /**
+   * Solves systems with the matrix of \ref laplacian_setup. The grid hierarchy is built by
+   * coarsening a grid of size m x n to (m-1)/2 x (n-1)/2 until at most `coarse_size`
+   * unknowns remain. The cycle uses damped Jacobi smoothing, full-weighting restriction,
+   * bilinear prolongation and a direct \ref LU solve on the coarsest grid. The coarse grid
+   * operators are rediscretizations, the five-point-stencil scaled by 1/4 per level. They
+   * differ from the Galerkin operators R*A*P of the transfer operators, which are nine-point
+   * stencils. The convergence is best for grid sizes of the form 2^k - 1, where the coarse
+   * grids are nested in the fine grids.
+   *
+   * With the same number of pre- and post-smoothing steps the cycle is a symmetric
+   * positive definite operator, so \ref apply can be used as a preconditioner in \ref pcg.
+   **/
+  class GeometricMultigrid
+  {
+  public:
+    using size_type  = std::size_t;
+    using value_type = double;
+
+  public:
+    /// Constructor
+    /**
+     * \param m, n         the grid size of the finest level
+     * \param gamma        number of coarse-grid corrections per level: 1 = V-cycle, 2 = W-cycle
+     * \param nu1, nu2     number of pre- and post-smoothing steps
+     * \param coarse_size  maximal number of unknowns on the coarsest level
+     * \param omega        the damping parameter of the Jacobi smoother
+     *
+     * Both directions are coarsened together, so a thin grid may reach a side length below 3
+     * with more than `coarse_size` unknowns left. Then the coarse grid matrix would be a dense
+     * matrix of that size, and std::invalid_argument is thrown instead.
+     **/
+    GeometricMultigrid(size_type m, size_type n, int gamma = 1, int nu1 = 2, int nu2 = 2,
+                       size_type coarse_size = 100, value_type omega = 0.8);
+
+    /// apply one cycle with initial guess z = 0 to the system A*z = r, i.e., z ~ A^{-1} r
+    void apply(DenseVector const& r, DenseVector& z) const;
+
+    /// apply one cycle to the system A*x = b, improving the given x
+    void cycle(DenseVector& x, DenseVector const& b) const;
+
+    /// return the number of grid levels
+    size_type levels() const
+    {
+      return levels_.size();
+    }
+
+    /// return the number of rows of the system matrix on the finest level
+    size_type rows() const
+    {
+      return levels_.front().m * levels_.front().n;
+    }
+
+    /// return the matrix-free system operator on the finest level
+    LaplacianOperator op() const
+    {
+      return {levels_.front().m, levels_.front().n};
+    }
+
+  private:
+    struct Level
+    {
+      size_type m, n;           // grid size
+      value_type scale;         // the operator is scale * five-point-stencil
+      mutable DenseVector x, b, r;
+    };
+
+    // recursive cycle on level l with right-hand side levels_[l].b and solution levels_[l].x
+    void cycle(size_type l) const;
+
+    // damped Jacobi smoothing steps on level l
+    void smooth(size_type l, int steps) const;
+
+    // residual r = b - A*x on level l
+    void residual(size_type l) const;
+
+    // full-weighting restriction of the residual of level l to the right-hand side of level l+1
+    void restrict_residual(size_type l) const;
+
+    // bilinear prolongation of the solution of level l+1, added to the solution of level l
+    void prolongate_add(size_type l) const;
+
+  private:
+    std::vector<Level> levels_;
+    LU coarse_solver_;
+    int gamma_, nu1_, nu2_;
+    value_type omega_;
+  };
+
+
+  /// Apply multigrid cycles to the linear system A*x = b and return an error code
+  /**
+   * \param mg    The multigrid solver for the system matrix A of \ref laplacian_setup
+   * \param x     The solution vector. Must be of correct size.
+   * \param b     The load vector of the linear system
+   * \param iter  An iteration object controlling number of iterations and break tolerances.
+   *
+   * \return The error code of the \ref BasicIteration object. err=0 means no error.
+   **/
+  int multigrid(GeometricMultigrid const& mg, DenseVector& x, DenseVector const& b, BasicIteration& iter);
+
+} // end namespace scprog
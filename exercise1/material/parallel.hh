@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace scprog
+{
+  /// Utilities for thread-parallel kernels with a deterministic work decomposition.
+  /**
+   * A range [0, n) is split into a number of blocks that depends only on n, never on the
+   * number of threads. Reductions compute one partial result per block and combine these
+   * partial results in block order. Thus, results are bitwise reproducible for any number
+   * of threads, including the sequential case.
+   *
+   * Threads are only used if the code is compiled with OpenMP support, e.g. `-fopenmp`.
+   **/
+  namespace parallel
+  {
+    /// minimal number of entries per block
+    constexpr std::size_t min_block_size = 4096;
+
+    /// maximal number of blocks a range is split into
+    constexpr std::size_t max_blocks = 1024;
+
+    /// mutable access to the number of threads used by the parallel kernels
+    inline int& num_threads_ref()
+    {
+#ifdef _OPENMP
+      static int n = omp_get_max_threads();
+#else
+      static int n = 1;
+#endif
+      return n;
+    }
+
+    /// return the number of threads used by the parallel kernels
+    inline int num_threads()
+    {
+      return num_threads_ref();
+    }
+
+    /// set the number of threads used by the parallel kernels, 1 means sequential execution
+    inline void set_num_threads(int n)
+    {
+      num_threads_ref() = std::max(n, 1);
+    }
+
+    /// mutable access to the flag whether containers are filled in parallel on construction
+    inline bool& first_touch_ref()
+    {
+      static bool enabled = true;
+      return enabled;
+    }
+
+    /// return whether containers are filled in parallel on construction
+    inline bool first_touch()
+    {
+      return first_touch_ref();
+    }
+
+    /// Set the construction mode of vectors and matrices
+    /**
+     * If enabled, the entries are filled on construction with the same partition and the
+     * same static thread assignment as used by the compute kernels. On NUMA systems, the
+     * memory pages are then first touched, and thus placed, on the node of the thread that
+     * later works on them. If disabled, the entries are filled by the calling thread only.
+     **/
+    inline void set_first_touch(bool enabled)
+    {
+      first_touch_ref() = enabled;
+    }
+
+    /// return the number of blocks the range [0, n) is split into
+    inline std::size_t num_blocks(std::size_t n)
+    {
+      return std::max<std::size_t>(1, std::min(max_blocks, (n + min_block_size - 1) / min_block_size));
+    }
+
+    /// return the number of blocks the rows [0, r) of a matrix with a total number of
+    /// entries are split into, such that a block holds about min_block_size entries
+    inline std::size_t num_row_blocks(std::size_t r, std::size_t entries)
+    {
+      std::size_t nb = std::min(max_blocks, (entries + min_block_size - 1) / min_block_size);
+      return std::max<std::size_t>(1, std::min(nb, r));
+    }
+
+    /// return the first index of block b in the range [0, n) split into nb blocks
+    inline std::size_t block_begin(std::size_t b, std::size_t nb, std::size_t n)
+    {
+      return (n / nb) * b + std::min(b, n % nb);
+    }
+
+    /// return the index of the block starting at first in the range [0, n) split into nb blocks
+    inline std::size_t block_index(std::size_t first, std::size_t nb, std::size_t n)
+    {
+      std::size_t const q = n / nb, rem = n % nb;
+      if (q == 0)
+        return first;
+      // the first rem blocks have size q+1, the remaining blocks size q
+      return first < rem*(q+1) ? first / (q+1) : rem + (first - rem*(q+1)) / q;
+    }
+
+
+    /// Call f(begin, end) for all blocks of the range [0, n) split into nb blocks in parallel
+    template <class F>
+    void for_each_block(std::size_t n, std::size_t nb, F f)
+    {
+      assert(nb > 0 && nb <= max_blocks);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(num_threads()) if(num_threads() > 1 && nb > 1)
+#endif
+      for (std::size_t b = 0; b < nb; ++b)
+        f(block_begin(b, nb, n), block_begin(b+1, nb, n));
+    }
+
+    /// Call f(begin, end) for all blocks of the range [0, n) in parallel
+    template <class F>
+    void for_each_block(std::size_t n, F f)
+    {
+      for_each_block(n, num_blocks(n), f);
+    }
+
+
+    /// Compute r_b = f(begin, end) for all blocks of the range [0, n) split into nb blocks in
+    /// parallel and return the combination op(...op(op(init, r_0), r_1)..., r_nb) in block order
+    template <class T, class F, class Op>
+    T reduce_blocks(std::size_t n, std::size_t nb, T init, F f, Op op)
+    {
+      assert(nb > 0 && nb <= max_blocks);
+      std::array<T, max_blocks> partial;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(num_threads()) if(num_threads() > 1 && nb > 1)
+#endif
+      for (std::size_t b = 0; b < nb; ++b)
+        partial[b] = f(block_begin(b, nb, n), block_begin(b+1, nb, n));
+
+      T result = init;
+      for (std::size_t b = 0; b < nb; ++b)
+        result = op(result, partial[b]);
+      return result;
+    }
+
+    /// Compute r_b = f(begin, end) for all blocks of the range [0, n) in parallel and return
+    /// the combination op(...op(op(init, r_0), r_1)..., r_nb) in block order
+    template <class T, class F, class Op>
+    T reduce_blocks(std::size_t n, T init, F f, Op op)
+    {
+      return reduce_blocks(n, num_blocks(n), init, f, op);
+    }
+
+  } // end namespace parallel
+} // end namespace scprog
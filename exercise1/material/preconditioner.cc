@@ -0,0 +1,137 @@
+#include <cmath>
+#include "preconditioner.hh"
+
+namespace scprog {
+
+// apply the preconditioner, z = D^{-1} r
+void JacobiPreconditioner::apply(DenseVector const& r, DenseVector& z) const
+{
+  assert(r.size() == inv_diag_.size());
+  assert(z.size() == inv_diag_.size());
+  for (std::size_t i = 0; i < inv_diag_.size(); ++i)
+    z[i] = inv_diag_[i] * r[i];
+}
+
+
+// store a reference to the matrix A and extract its diagonal
+void SSORPreconditioner::compute(CRSMatrix const& A)
+{
+  assert(A.rows() == A.cols());
+  A_ = &A;
+  diag_.resize(A.rows());
+  for (std::size_t i = 0; i < A.rows(); ++i) {
+    diag_[i] = A(i,i);
+    assert(diag_[i] != value_type(0));
+  }
+}
+
+
+// apply the preconditioner by a forward and a backward sweep, z = M^{-1} r
+void SSORPreconditioner::apply(DenseVector const& r, DenseVector& z) const
+{
+  assert(A_ != nullptr);
+  auto const& offsets = A_->offsets();
+  auto const& indices = A_->indices();
+  auto const& values = A_->values();
+  std::size_t const n = diag_.size();
+  assert(r.size() == n);
+  assert(z.size() == n);
+
+  // forward sweep: (D/omega + L) z = r
+  for (std::size_t i = 0; i < n; ++i) {
+    value_type f = r[i];
+    for (std::size_t k = offsets[i]; k < offsets[i+1] && indices[k] < i; ++k)
+      f -= values[k] * z[indices[k]];
+    z[i] = omega_ * f / diag_[i];
+  }
+
+  // scaling: z = (2-omega)/omega * (D/omega) z
+  for (std::size_t i = 0; i < n; ++i)
+    z[i] *= (2 - omega_) / omega_ * diag_[i] / omega_;
+
+  // backward sweep: (D/omega + U) z = z
+  for (std::size_t j = 0; j < n; ++j) {
+    std::size_t i = n-j-1;
+    value_type f = z[i];
+    for (std::size_t k = offsets[i+1]; k > offsets[i] && indices[k-1] > i; --k)
+      f -= values[k-1] * z[indices[k-1]];
+    z[i] = omega_ * f / diag_[i];
+  }
+}
+
+
+// compute the incomplete factorization of A
+void IC0Preconditioner::compute(CRSMatrix const& A)
+{
+  using std::sqrt;
+  assert(A.rows() == A.cols());
+  auto const& a_offsets = A.offsets();
+  auto const& a_indices = A.indices();
+  auto const& a_values = A.values();
+  size_type const n = A.rows();
+
+  // 1. copy the lower triangle of A, including the diagonal
+  offsets_.assign(n+1, 0);
+  indices_.clear();
+  values_.clear();
+  for (size_type i = 0; i < n; ++i) {
+    for (size_type k = a_offsets[i]; k < a_offsets[i+1] && a_indices[k] <= i; ++k) {
+      indices_.push_back(a_indices[k]);
+      values_.push_back(a_values[k]);
+    }
+    assert(!indices_.empty() && indices_.back() == i);  // diagonal entry must exist
+    offsets_[i+1] = indices_.size();
+  }
+
+  // 2. row-wise factorization restricted to the sparsity pattern
+  for (size_type i = 0; i < n; ++i) {
+    for (size_type k = offsets_[i]; k < offsets_[i+1]; ++k) {
+      size_type j = indices_[k];
+
+      // subtract sum_{l<j} L(i,l)*L(j,l) by merging the sorted rows i and j
+      value_type s = values_[k];
+      size_type ki = offsets_[i], kj = offsets_[j];
+      while (ki < k && kj < offsets_[j+1]-1) {
+        if (indices_[ki] < indices_[kj])      ++ki;
+        else if (indices_[ki] > indices_[kj]) ++kj;
+        else                                  s -= values_[ki++] * values_[kj++];
+      }
+
+      if (j < i) {
+        values_[k] = s / values_[offsets_[j+1]-1];
+      } else {
+        assert(s > value_type(0));  // matrix is not SPD or the factorization broke down
+        values_[k] = sqrt(s);
+      }
+    }
+  }
+}
+
+
+// apply the preconditioner, z = (L*L^T)^{-1} r
+void IC0Preconditioner::apply(DenseVector const& r, DenseVector& z) const
+{
+  size_type const n = offsets_.size()-1;
+  assert(r.size() == n);
+  assert(z.size() == n);
+
+  // forward substitution: L y = r
+  for (size_type i = 0; i < n; ++i) {
+    value_type f = r[i];
+    size_type diag = offsets_[i+1]-1;
+    for (size_type k = offsets_[i]; k < diag; ++k)
+      f -= values_[k] * z[indices_[k]];
+    z[i] = f / values_[diag];
+  }
+
+  // backward substitution: L^T z = y, traversing the rows of L in reverse order
+  for (size_type j = 0; j < n; ++j) {
+    size_type i = n-j-1;
+    size_type diag = offsets_[i+1]-1;
+    z[i] /= values_[diag];
+    for (size_type k = offsets_[i]; k < diag; ++k)
+      z[indices_[k]] -= values_[k] * z[i];
+  }
+}
+
+} // end namespace scprog
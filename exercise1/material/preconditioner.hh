@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+#include "linear_algebra.hh"
+
+namespace scprog
+{
+  /// Jacobi (diagonal) preconditioner, z = D^{-1} r
+  class JacobiPreconditioner
+  {
+  public:
+    using value_type = double;
+
+    /// extract the inverse diagonal of the matrix A, that must provide access A(i,i)
+    template <class Matrix>
+    void compute(Matrix const& A)
+    {
+      assert(A.rows() == A.cols());
+      inv_diag_.resize(A.rows());
+      for (std::size_t i = 0; i < A.rows(); ++i) {
+        assert(A(i,i) != value_type(0));
+        inv_diag_[i] = value_type(1) / A(i,i);
+      }
+    }
+
+    /// apply the preconditioner, z = D^{-1} r
+    void apply(DenseVector const& r, DenseVector& z) const;
+
+  private:
+    std::vector<value_type> inv_diag_;
+  };
+
+
+  /// Symmetric successive over-relaxation (SSOR) preconditioner for sparse matrices
+  /**
+   * Applies M^{-1} with M = 1/(2-omega) (D + omega L) D^{-1} (D + omega U), where
+   * A = L + D + U. This is omega times the usual SSOR matrix, which has the factor
+   * 1/(omega (2-omega)), a scaling that does not change the iterates of \ref pcg. For
+   * omega = 1 this is the symmetric Gauss-Seidel preconditioner.
+   **/
+  class SSORPreconditioner
+  {
+  public:
+    using value_type = double;
+
+    /// constructor with relaxation parameter omega in (0,2)
+    explicit SSORPreconditioner(value_type omega = 1)
+      : omega_(omega)
+    {
+      assert(omega > 0 && omega < 2);
+    }
+
+    /// store a reference to the matrix A and extract its diagonal
+    void compute(CRSMatrix const& A);
+
+    /// apply the preconditioner by a forward and a backward sweep, z = M^{-1} r
+    void apply(DenseVector const& r, DenseVector& z) const;
+
+  private:
+    value_type omega_;
+    CRSMatrix const* A_ = nullptr;
+    std::vector<value_type> diag_;
+  };
+
+
+  /// Incomplete Cholesky preconditioner without fill-in, IC(0), for sparse SPD matrices
+  /**
+   * Computes a lower triangular factor L with the sparsity pattern of the lower triangle
+   * of A, such that A ~ L*L^T, and applies z = (L*L^T)^{-1} r by two triangular solves.
+   **/
+  class IC0Preconditioner
+  {
+  public:
+    using value_type = double;
+    using size_type  = std::size_t;
+
+    /// compute the incomplete factorization of A, that must have sorted column indices
+    void compute(CRSMatrix const& A);
+
+    /// apply the preconditioner, z = (L*L^T)^{-1} r
+    void apply(DenseVector const& r, DenseVector& z) const;
+
+  private:
+    // the factor L in compressed row storage, the diagonal is the last entry in each row
+    std::vector<size_type> offsets_;
+    std::vector<size_type> indices_;
+    std::vector<value_type> values_;
+  };
+
+} // end namespace scprog
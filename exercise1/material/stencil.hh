@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <vector>
+
+#include "linear_algebra.hh"
+#include "parallel.hh"
+
+namespace scprog
+{
+  /// A finite-difference stencil on a structured grid
+  /**
+   * The grid of size m x n x l is numbered lexicographically with the last index running
+   * fastest, i.e., the grid point (i,j,k) corresponds to the row (i*n + j)*l + k. For 2D
+   * grids l = 1, which gives the numbering of \ref laplacian_setup.
+   *
+   * The entries are sorted by their offset, such that the column indices of a row are
+   * increasing.
+   **/
+  class Stencil
+  {
+  public:
+    /// An entry of the stencil: the offset (di,dj,dk) of the neighbour and the weight
+    struct Entry
+    {
+      int di, dj, dk;
+      double weight;
+    };
+
+    /// constructor from a list of entries
+    Stencil(std::initializer_list<Entry> entries)
+      : entries_(entries)
+    {
+      std::sort(entries_.begin(), entries_.end(), [](Entry const& a, Entry const& b) {
+        return std::tie(a.di, a.dj, a.dk) < std::tie(b.di, b.dj, b.dk);
+      });
+    }
+
+    /// return the number of entries
+    std::size_t size() const
+    {
+      return entries_.size();
+    }
+
+    /// return the e-th entry
+    Entry const& operator[](std::size_t e) const
+    {
+      assert(e < entries_.size());
+      return entries_[e];
+    }
+
+  private:
+    std::vector<Entry> entries_;
+  };
+
+
+  /// The five-point-stencil of the negative Laplacian in 2D, scaled by h^2
+  inline Stencil five_point_stencil()
+  {
+    return {{-1,0,0,-1.0}, {0,-1,0,-1.0}, {0,0,0,4.0}, {0,1,0,-1.0}, {1,0,0,-1.0}};
+  }
+
+  /// The compact nine-point-stencil (Mehrstellen) of the negative Laplacian in 2D, scaled by h^2
+  inline Stencil nine_point_stencil()
+  {
+    double const c = -1.0/6.0, e = -2.0/3.0;
+    return {{-1,-1,0,c}, {-1,0,0,e}, {-1,1,0,c},
+            { 0,-1,0,e}, { 0,0,0,10.0/3.0}, { 0,1,0,e},
+            { 1,-1,0,c}, { 1,0,0,e}, { 1,1,0,c}};
+  }
+
+  /// The five-point-stencil of the convection-diffusion operator -Laplace(u) + (bx,by)*grad(u)
+  /// in 2D with central differences, scaled by h^2. The arguments are the velocity times h,
+  /// i.e., twice the cell Peclet numbers. The operator is nonsymmetric for nonzero velocity.
+  inline Stencil convection_diffusion_stencil(double bx, double by)
+  {
+    return {{-1,0,0,-1.0 - bx/2}, {0,-1,0,-1.0 - by/2}, {0,0,0,4.0},
+            {0,1,0,-1.0 + by/2}, {1,0,0,-1.0 + bx/2}};
+  }
+
+  /// The seven-point-stencil of the negative Laplacian in 3D, scaled by h^2
+  inline Stencil seven_point_stencil()
+  {
+    return {{-1,0,0,-1.0}, {0,-1,0,-1.0}, {0,0,-1,-1.0}, {0,0,0,6.0},
+            {0,0,1,-1.0}, {0,1,0,-1.0}, {1,0,0,-1.0}};
+  }
+
+
+  /// Assemble the sparse matrix of a stencil with variable coefficients on a grid of size
+  /// m x n x l
+  /**
+   * Rows are assembled in parallel, by the blocks of rows of the matrix-vector product,
+   * directly into the compressed arrays of the matrix. First, the number of neighbours
+   * inside the grid is counted per row, then the row offsets are computed by a blocked
+   * prefix sum, and finally the column indices and values are written. Neighbours outside
+   * the grid are dropped, corresponding to homogeneous Dirichlet boundary conditions.
+   *
+   * \param weight  A functor `weight(i,j,k,e)` returning the weight of the e-th stencil
+   *                entry in the row of the grid point (i,j,k). Called concurrently.
+   **/
+  template <class Weight>
+  void stencil_setup(CRSMatrix& A, Stencil const& s, std::size_t m, std::size_t n,
+                     std::size_t l, Weight weight)
+  {
+    using size_type = CRSMatrix::size_type;
+    size_type const rows = m*n*l;
+    size_type const nb = parallel::num_row_blocks(rows, rows*s.size());
+
+    // number of stencil entries of row (i,j,k) that fall inside the grid
+    auto inside = [m,n,l](size_type i, size_type j, size_type k, Stencil::Entry const& e) {
+      return std::ptrdiff_t(i) + e.di >= 0 && std::ptrdiff_t(i) + e.di < std::ptrdiff_t(m) &&
+             std::ptrdiff_t(j) + e.dj >= 0 && std::ptrdiff_t(j) + e.dj < std::ptrdiff_t(n) &&
+             std::ptrdiff_t(k) + e.dk >= 0 && std::ptrdiff_t(k) + e.dk < std::ptrdiff_t(l);
+    };
+
+    // 1. count the entries per row and per block of rows
+    CRSMatrix::index_array offsets(rows + 1);
+    std::array<size_type, parallel::max_blocks + 1> block_offset;
+    size_type* o = offsets.data();
+    parallel::for_each_block(rows, nb, [&](size_type first, size_type last) {
+      size_type count = 0;
+      for (size_type r = first; r < last; ++r) {
+        size_type i = r / (n*l), j = (r / l) % n, k = r % l;
+        size_type c = 0;
+        for (std::size_t e = 0; e < s.size(); ++e)
+          c += inside(i, j, k, s[e]) ? 1 : 0;
+        o[r+1] = c;
+        count += c;
+      }
+      block_offset[parallel::block_index(first, nb, rows) + 1] = count;
+    });
+
+    // 2. prefix sum over the blocks, then over the rows of each block
+    block_offset[0] = 0;
+    for (size_type b = 0; b < nb; ++b)
+      block_offset[b+1] += block_offset[b];
+    o[0] = 0;
+    parallel::for_each_block(rows, nb, [&](size_type first, size_type last) {
+      size_type offset = block_offset[parallel::block_index(first, nb, rows)];
+      for (size_type r = first; r < last; ++r) {
+        offset += o[r+1];
+        o[r+1] = offset;
+      }
+    });
+
+    // 3. write the column indices and values of each row
+    size_type const nnz = block_offset[nb];
+    CRSMatrix::index_array indices(nnz);
+    CRSMatrix::value_array values(nnz);
+    size_type* idx = indices.data();
+    double* val = values.data();
+    parallel::for_each_block(rows, nb, [&](size_type first, size_type last) {
+      for (size_type r = first; r < last; ++r) {
+        size_type i = r / (n*l), j = (r / l) % n, k = r % l;
+        size_type pos = o[r];
+        for (std::size_t e = 0; e < s.size(); ++e) {
+          if (inside(i, j, k, s[e])) {
+            std::ptrdiff_t shift = (std::ptrdiff_t(s[e].di)*n + s[e].dj)*l + s[e].dk;
+            idx[pos] = r + shift;
+            val[pos] = weight(i, j, k, e);
+            ++pos;
+          }
+        }
+      }
+    });
+
+    A = CRSMatrix(rows, rows, std::move(offsets), std::move(indices), std::move(values));
+  }
+
+
+  /// Assemble the sparse matrix of a stencil with constant coefficients on a grid of size
+  /// m x n x l, see \ref stencil_setup
+  inline void stencil_setup(CRSMatrix& A, Stencil const& s, std::size_t m, std::size_t n,
+                            std::size_t l = 1)
+  {
+    stencil_setup(A, s, m, n, l, [&s](std::size_t, std::size_t, std::size_t, std::size_t e) {
+      return s[e].weight;
+    });
+  }
+
+
+  /// Assemble the dense matrix of a stencil with constant coefficients on a grid of size
+  /// m x n x l. The zero entries are filled in parallel by blocks of rows, followed by the
+  /// stencil entries of the same rows.
+  inline void stencil_setup(DenseMatrix& A, Stencil const& s, std::size_t m, std::size_t n,
+                            std::size_t l = 1)
+  {
+    using size_type = DenseMatrix::size_type;
+    size_type const rows = m*n*l;
+    A.resize(0, 0);
+    A.resize(rows, rows, 0.0);
+
+    double* a = A.data();
+    parallel::for_each_block(rows, parallel::num_row_blocks(rows, rows*rows),
+      [=,&s](size_type first, size_type last) {
+        for (size_type r = first; r < last; ++r) {
+          std::ptrdiff_t i = r / (n*l), j = (r / l) % n, k = r % l;
+          for (std::size_t e = 0; e < s.size(); ++e) {
+            std::ptrdiff_t ii = i + s[e].di, jj = j + s[e].dj, kk = k + s[e].dk;
+            if (ii >= 0 && ii < std::ptrdiff_t(m) && jj >= 0 && jj < std::ptrdiff_t(n) &&
+                kk >= 0 && kk < std::ptrdiff_t(l))
+              a[r*rows + (ii*n + jj)*l + kk] = s[e].weight;
+          }
+        }
+      });
+  }
+
+} // end namespace scprog
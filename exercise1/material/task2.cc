@@ -10,7 +10,7 @@ int main(int argc, char** argv)
   DenseVector b(n*n, 1.0);
 
   // system matrix
-  DenseMatrix A;
+  CRSMatrix A;
   laplacian_setup(A,n,n);
 
   // solution vector
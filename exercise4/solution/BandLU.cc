@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "BandLU.hh"
+
+namespace scprog {
+
+// Banded LU decomposition with partial pivoting. The pivot of column j is searched in the
+// kl rows below the diagonal only, and the row swaps are applied to the columns of U only.
+// The multipliers stay in the rows where they were computed, so the swaps have to be
+// applied step by step in the forward elimination.
+void BandLU::compute (BandMatrix const& A)
+{
+  n_ = A.rows();
+  kl_ = A.lower();
+  ku_ = A.upper();
+  width_ = 2*kl_ + ku_ + 1;
+
+  // copy the band of A, with kl additional zero super-diagonals for the fill-in
+  decomposition_.assign(n_ * width_, 0.0);
+  pivot_.resize(n_);
+  for (std::size_t i = 0; i < n_; ++i)
+    for (std::size_t j = (i > kl_ ? i - kl_ : 0); j < std::min(n_, i + ku_ + 1); ++j)
+      at(i,j) = A(i,j);
+
+  for (std::size_t j = 0; j < n_; ++j) {
+    std::size_t last = std::min(n_, j + kl_ + 1);
+    std::size_t end = std::min(n_, j + kl_ + ku_ + 1);
+
+    // choose the largest entry of column j as pivot
+    std::size_t p = j;
+    for (std::size_t i = j+1; i < last; ++i)
+      if (std::abs(at(i,j)) > std::abs(at(p,j)))
+        p = i;
+    pivot_[j] = p;
+    if (p != j)
+      for (std::size_t c = j; c < end; ++c)
+        std::swap(at(j,c), at(p,c));
+
+    double const ajj = at(j,j);
+    assert(ajj != 0.0); // the matrix is singular
+    for (std::size_t i = j+1; i < last; ++i) {
+      double const lij = at(i,j) /= ajj;
+      for (std::size_t c = j+1; c < end; ++c)
+        at(i,c) -= lij * at(j,c);
+    }
+  }
+}
+
+
+void BandLU::apply (Vector const& b, Vector& x) const
+{
+  assert(n_ == x.size());
+  assert(n_ == b.size());
+
+  x = b;
+  apply(x);
+}
+
+
+void BandLU::apply (Vector& x) const
+{
+  assert(n_ == x.size());
+
+  // forward elimination, with the row swaps applied step by step
+  for (std::size_t j = 0; j < n_; ++j) {
+    std::swap(x[j], x[pivot_[j]]);
+    double const xj = x[j];
+    for (std::size_t i = j+1; i < std::min(n_, j + kl_ + 1); ++i)
+      x[i] -= at(i,j) * xj;
+  }
+
+  // backward elimination
+  for (std::size_t i = n_; i > 0; --i) {
+    Vector::value_type f = 0;
+    for (std::size_t c = i; c < std::min(n_, i + kl_ + ku_); ++c)
+      f += at(i-1,c) * x[c];
+    x[i-1] = (x[i-1] - f) / at(i-1,i-1);
+  }
+}
+
+} // end namespace scprog
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include "BandMatrix.hh"
+#include "Vector.hh"
+
+namespace scprog
+{
+  // LU decomposition with partial pivoting, P*A = L*U, of a band matrix with kl sub- and ku
+  // super-diagonals. L keeps kl sub-diagonals and U gets kl+ku super-diagonals by the row
+  // swaps. The decomposition costs O(n*kl*(kl+ku)) and a solve O(n*(2*kl+ku)) operations.
+  class BandLU
+  {
+  public:
+    // decomposing the matrix m, without modifing it
+    void compute (BandMatrix const& A);
+
+    // Solve the linear system A*x = b using the decomposed matrix
+    void apply (Vector const& b, Vector& x) const;
+
+    // Solve the linear system A*x = b in place, with x = b on input. Does not allocate.
+    void apply (Vector& x) const;
+
+  private:
+    // access to the entry (i,j) of the decomposition, with i-kl <= j <= i+kl+ku
+    double& at (std::size_t i, std::size_t j)
+    {
+      return decomposition_[i*width_ + j + kl_ - i];
+    }
+
+    double const& at (std::size_t i, std::size_t j) const
+    {
+      return decomposition_[i*width_ + j + kl_ - i];
+    }
+
+  private:
+    std::size_t n_ = 0, kl_ = 0, ku_ = 0, width_ = 0;
+    std::vector<double> decomposition_; // the columns [i-kl, i+kl+ku] of row i of L and U
+    std::vector<std::size_t> pivot_;    // row j was swapped with row pivot_[j] in step j
+  };
+
+} // end namespace scprog
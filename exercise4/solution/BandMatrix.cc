@@ -0,0 +1,31 @@
+#include <algorithm>
+
+#include "BandMatrix.hh"
+#include "Vector.hh"
+
+namespace scprog {
+
+BandMatrix::BandMatrix (size_type const n, size_type const lower, size_type const upper)
+  : n_(n)
+  , lower_(lower)
+  , upper_(upper)
+  , data_(n*(lower+upper+1), value_type(0))
+{}
+
+
+void BandMatrix::mv (Vector const& x, Vector& y) const
+{
+  assert(n_ == y.size());
+  assert(n_ == x.size());
+  for (std::size_t i = 0; i < n_; ++i)
+  {
+    std::size_t j0 = i > lower_ ? i - lower_ : 0;
+    std::size_t j1 = std::min(n_, i + upper_ + 1);
+    value_type f = 0;
+    for (std::size_t j = j0; j < j1; ++j)
+      f += data_[i*width() + j + lower_ - i] * x[j];
+    y[i] = f;
+  }
+}
+
+} // end namespace scprog
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+namespace scprog
+{
+  // forward declaration
+  class Vector;
+
+  // Square band matrix with `lower` sub-diagonals and `upper` super-diagonals. The entries
+  // of row i in the columns [i-lower, i+upper] are stored contiguously, row after row.
+  class BandMatrix
+  {
+  public:
+    // The data type of the matrix entries
+    using value_type = double;
+
+    // The data type of the size and indices
+    using size_type = std::size_t;
+
+  public:
+    // construct and initialize the band matrix of size n x n with the given bandwidths
+    BandMatrix (size_type n = 0, size_type lower = 0, size_type upper = 0);
+
+    // mutable access to the matrix entries inside the band
+    value_type& operator() (size_type const i, size_type const j)
+    {
+      assert(i < n_ && j < n_);
+      assert(j + lower_ >= i && j <= i + upper_);
+      return data_[i*width() + j + lower_ - i];
+    }
+
+    // const access to the matrix entries inside the band
+    value_type const& operator() (size_type const i, size_type const j) const
+    {
+      assert(i < n_ && j < n_);
+      assert(j + lower_ >= i && j <= i + upper_);
+      return data_[i*width() + j + lower_ - i];
+    }
+
+    // return the number of rows
+    size_type rows () const
+    {
+      return n_;
+    }
+
+    // return the number of columns
+    size_type cols () const
+    {
+      return n_;
+    }
+
+    // return the number of sub-diagonals
+    size_type lower () const
+    {
+      return lower_;
+    }
+
+    // return the number of super-diagonals
+    size_type upper () const
+    {
+      return upper_;
+    }
+
+    // return the number of stored entries per row
+    size_type width () const
+    {
+      return lower_ + upper_ + 1;
+    }
+
+    // matrix-vector product y = A*x
+    void mv (Vector const& x, Vector& y) const;
+
+  private:
+    std::size_t n_;
+    std::size_t lower_;
+    std::size_t upper_;
+    std::vector<double> data_;
+  };
+
+} // end namespace scprog
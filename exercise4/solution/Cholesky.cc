@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "Cholesky.hh"
+
+namespace scprog {
+
+namespace {
+
+// number of rows of a panel factorized together, and of a tile of previous rows
+constexpr std::size_t panel = 32;
+
+// length of the row segments in the panel update, such that a tile of previous rows
+// and the rows of the panel stay in the L2 cache
+constexpr std::size_t inner_tile = 256;
+
+
+// offset of row i in the packed lower triangle
+inline std::size_t row_offset (std::size_t i)
+{
+  return i*(i+1)/2;
+}
+
+
+// Copy the lower triangle of A row by row into the packed storage f
+void pack_lower (DenseMatrix const& A, std::vector<double>& f)
+{
+  assert(A.rows() == A.cols());
+  std::size_t n = A.rows();
+  f.resize(row_offset(n));
+  for (std::size_t i = 0; i < n; ++i)
+    std::copy(A.data() + i*n, A.data() + i*n + i+1, f.begin() + row_offset(i));
+}
+
+
+// Return the dot product x[k0:k1] * y[k0:k1]. The partial sums are kept in V independent
+// lanes, so the loop vectorizes.
+inline double dot (double const* x, double const* y, std::size_t k0, std::size_t k1)
+{
+  constexpr std::size_t V = 4;
+  double acc[V] = {};
+  std::size_t k = k0;
+  for (; k + V <= k1; k += V)
+    for (std::size_t v = 0; v < V; ++v)
+      acc[v] += x[k+v] * y[k+v];
+
+  double s = 0;
+  for (std::size_t v = 0; v < V; ++v)
+    s += acc[v];
+  for (; k < k1; ++k)
+    s += x[k] * y[k];
+  return s;
+}
+
+
+// Subtract from the entries [j0, j0+cols) of the R rows c the products of the segments
+// [k0, k1) of the R rows x with the tile bt, which holds the same segments of `cols`
+// previous rows transposed, bt[(k-k0)*panel + r] = L(t0+r, k). The segments of x are copied
+// to the contiguous buffer l, and blocks of R x C entries are accumulated in registers.
+template <std::size_t R, std::size_t C = 8>
+void update_rows (double const* const* x, double const* bt, std::size_t k0, std::size_t k1,
+                  double* const* c, std::size_t j0, std::size_t cols, double* l)
+{
+  std::size_t kb = k1 - k0;
+  for (std::size_t p = 0; p < kb; ++p)
+    for (std::size_t q = 0; q < R; ++q)
+      l[p*R + q] = x[q][k0 + p];
+
+  std::size_t j = 0;
+  for (; j + C <= cols; j += C) {
+    double acc[R][C] = {};
+    for (std::size_t p = 0; p < kb; ++p)
+      for (std::size_t q = 0; q < R; ++q)
+        for (std::size_t cc = 0; cc < C; ++cc)
+          acc[q][cc] += l[p*R + q] * bt[p*panel + j + cc];
+
+    for (std::size_t q = 0; q < R; ++q)
+      for (std::size_t cc = 0; cc < C; ++cc)
+        c[q][j0 + j + cc] -= acc[q][cc];
+  }
+
+  // remaining columns
+  for (std::size_t q = 0; q < R; ++q)
+    for (std::size_t p = 0; p < kb; ++p)
+      for (std::size_t jr = j; jr < cols; ++jr)
+        c[q][j0 + jr] -= l[p*R + q] * bt[p*panel + jr];
+}
+
+
+// Compute the entries [0, i0) of the rb <= panel rows starting at i0 of the packed factor f
+// from the finished rows above, in tiles of `panel` previous rows:
+// - subtract the dot products of the already finished columns [0, t0) as a blocked
+//   matrix-matrix product, with row segments of length inner_tile,
+// - compute the columns [t0, t1) of the tile one after another.
+// The left operands of the dot products are the rows w, which are the factor rows themselves
+// for Cholesky and the rows of L*D for LDL^T. The new entries of the rows of L are divided by
+// the diagonal entries of the tile rows and, if scale_w is set, stored unscaled in w.
+void factor_rows (double* f, double* const* w, std::size_t i0, std::size_t rb, bool scale_w)
+{
+  double* li[panel];
+  for (std::size_t q = 0; q < rb; ++q)
+    li[q] = f + row_offset(i0+q);
+
+  // transposed tile of previous rows and copy of the panel rows for update_rows
+  std::vector<double> bt(inner_tile * panel), l(inner_tile * 4);
+
+  double const* lt[panel];
+  for (std::size_t t0 = 0; t0 < i0; t0 += panel) {
+    std::size_t t1 = std::min(t0 + panel, i0);
+    for (std::size_t j = t0; j < t1; ++j)
+      lt[j-t0] = f + row_offset(j);
+
+    for (std::size_t k0 = 0; k0 < t0; k0 += inner_tile) {
+      std::size_t k1 = std::min(k0 + inner_tile, t0);
+      for (std::size_t k = k0; k < k1; ++k)
+        for (std::size_t r = 0; r < t1-t0; ++r)
+          bt[(k-k0)*panel + r] = lt[r][k];
+
+      std::size_t q = 0;
+      for (; q + 4 <= rb; q += 4)
+        update_rows<4>(w+q, bt.data(), k0, k1, li+q, t0, t1-t0, l.data());
+      for (; q < rb; ++q)
+        update_rows<1>(w+q, bt.data(), k0, k1, li+q, t0, t1-t0, l.data());
+    }
+
+    for (std::size_t j = t0; j < t1; ++j) {
+      double const ljj = lt[j-t0][j];
+      for (std::size_t q = 0; q < rb; ++q) {
+        double const v = li[q][j] - dot(w[q], lt[j-t0], t0, j);
+        li[q][j] = v / ljj;
+        w[q][j] = scale_w ? v : li[q][j];
+      }
+    }
+  }
+}
+
+} // end anonymous namespace
+
+
+// Blocked left-looking Cholesky decomposition, computed by panels of rows. The entries
+// left of the diagonal block of a panel are computed by factor_rows, the diagonal block row
+// by row.
+void Cholesky::compute (DenseMatrix const& A)
+{
+  pack_lower(A, factor_);
+  std::size_t n = A.rows();
+  double* f = factor_.data();
+
+  for (std::size_t i0 = 0; i0 < n; i0 += panel) {
+    std::size_t rb = std::min(panel, n-i0);
+
+    double* rows[panel];
+    for (std::size_t q = 0; q < rb; ++q)
+      rows[q] = f + row_offset(i0+q);
+    factor_rows(f, rows, i0, rb, false);
+
+    // diagonal block
+    for (std::size_t j = i0; j < i0+rb; ++j) {
+      double* lj = f + row_offset(j);
+      for (std::size_t i = j; i < i0+rb; ++i) {
+        double* li = f + row_offset(i);
+        double const v = li[j] - dot(li, lj, 0, j);
+        if (i == j) {
+          assert(v > 0.0); // the matrix is not positive definite
+          li[j] = std::sqrt(v);
+        } else
+          li[j] = v / lj[j];
+      }
+    }
+  }
+}
+
+
+void Cholesky::apply (Vector const& b, Vector& x) const
+{
+  assert(x.size() == b.size());
+
+  x = b;
+  apply(x);
+}
+
+
+void Cholesky::apply (Vector& x) const
+{
+  std::size_t n = x.size();
+  assert(factor_.size() == row_offset(n));
+  double const* f = factor_.data();
+
+  // forward elimination with L
+  for (std::size_t i = 0; i < n; ++i) {
+    double const* li = f + row_offset(i);
+    x[i] = (x[i] - dot(li, x.data(), 0, i)) / li[i];
+  }
+
+  // backward elimination with L^T, column by column of L^T
+  for (std::size_t i = n; i > 0; --i) {
+    double const* li = f + row_offset(i-1);
+    double const xi = x[i-1] /= li[i-1];
+    for (std::size_t k = 0; k < i-1; ++k)
+      x[k] -= li[k] * xi;
+  }
+}
+
+
+// Blocked left-looking LDL^T decomposition, computed by panels of rows as for Cholesky. For
+// the rows of a panel, the products L(i,k)*D(k) are kept in a work array, so each entry
+// costs one dot product as for Cholesky.
+void LDLT::compute (DenseMatrix const& A)
+{
+  pack_lower(A, factor_);
+  std::size_t n = A.rows();
+  double* f = factor_.data();
+
+  std::vector<double> work(panel * n);
+  double* w[panel];
+  for (std::size_t q = 0; q < panel; ++q)
+    w[q] = work.data() + q*n;
+
+  for (std::size_t i0 = 0; i0 < n; i0 += panel) {
+    std::size_t rb = std::min(panel, n-i0);
+    factor_rows(f, w, i0, rb, true);
+
+    // diagonal block
+    for (std::size_t j = i0; j < i0+rb; ++j) {
+      double* lj = f + row_offset(j);
+      for (std::size_t i = j; i < i0+rb; ++i) {
+        double* li = f + row_offset(i);
+        double const v = li[j] - dot(w[i-i0], lj, 0, j);
+        if (i == j) {
+          assert(v != 0.0); // the matrix is singular
+          li[j] = v;
+        } else {
+          w[i-i0][j] = v;
+          li[j] = v / lj[j];
+        }
+      }
+    }
+  }
+}
+
+
+void LDLT::apply (Vector const& b, Vector& x) const
+{
+  assert(x.size() == b.size());
+
+  x = b;
+  apply(x);
+}
+
+
+void LDLT::apply (Vector& x) const
+{
+  std::size_t n = x.size();
+  assert(factor_.size() == row_offset(n));
+  double const* f = factor_.data();
+
+  // forward elimination with the unit lower triangular L
+  for (std::size_t i = 0; i < n; ++i) {
+    double const* li = f + row_offset(i);
+    x[i] -= dot(li, x.data(), 0, i);
+  }
+
+  // scaling with D
+  for (std::size_t i = 0; i < n; ++i)
+    x[i] /= f[row_offset(i) + i];
+
+  // backward elimination with L^T, column by column of L^T
+  for (std::size_t i = n; i > 0; --i) {
+    double const* li = f + row_offset(i-1);
+    double const xi = x[i-1];
+    for (std::size_t k = 0; k < i-1; ++k)
+      x[k] -= li[k] * xi;
+  }
+}
+
+} // end namespace scprog
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+#include "DenseMatrix.hh"
+#include "Vector.hh"
+
+namespace scprog
+{
+  // Cholesky decomposition A = L*L^T of a symmetric positive definite matrix. Only the lower
+  // triangle of A is read, and L is stored packed row by row in n*(n+1)/2 entries.
+  class Cholesky
+  {
+  public:
+    // decomposing the matrix m, without modifing it
+    void compute (DenseMatrix const& A);
+
+    // Solve the linear system A*x = b using the decomposed matrix
+    void apply (Vector const& b, Vector& x) const;
+
+    // Solve the linear system A*x = b in place, with x = b on input. Does not allocate.
+    void apply (Vector& x) const;
+
+  private:
+    std::vector<double> factor_; // row i of L in the entries [i*(i+1)/2, (i+1)*(i+2)/2)
+  };
+
+
+  // LDL^T decomposition A = L*D*L^T of a symmetric matrix with L unit lower triangular and D
+  // diagonal, without pivoting. Only the lower triangle of A is read. L and D are stored
+  // packed row by row in n*(n+1)/2 entries, with D on the diagonal.
+  class LDLT
+  {
+  public:
+    // decomposing the matrix m, without modifing it
+    void compute (DenseMatrix const& A);
+
+    // Solve the linear system A*x = b using the decomposed matrix
+    void apply (Vector const& b, Vector& x) const;
+
+    // Solve the linear system A*x = b in place, with x = b on input. Does not allocate.
+    void apply (Vector& x) const;
+
+  private:
+    std::vector<double> factor_; // row i of L and D(i) in the entries [i*(i+1)/2, (i+1)*(i+2)/2)
+  };
+
+} // end namespace scprog
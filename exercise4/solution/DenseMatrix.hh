@@ -49,6 +49,18 @@ namespace scprog
       return cols_;
     }
 
+    // pointer to the contiguous row-wise matrix entries
+    value_type* data ()
+    {
+      return data_.data();
+    }
+
+    // const pointer to the contiguous row-wise matrix entries
+    value_type const* data () const
+    {
+      return data_.data();
+    }
+
     // matrix-vector product y = A*x
     void mv (Vector const& x, Vector& y) const;
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -6,21 +7,243 @@
 
 namespace scprog {
 
+namespace {
+
+// number of columns of the trailing matrix updated at once, such that the corresponding
+// block_size x column_tile part of U stays in the L2 cache
+constexpr std::size_t column_tile = 256;
+
+
+// Unblocked LU decomposition with partial pivoting of the panel of columns [k, k+kb) and
+// rows [k, n) of the n x n matrix a. Row swaps are applied to the columns [s0, s1), which
+// must contain the panel.
+void factor_panel (double* a, std::size_t n, std::size_t k, std::size_t kb, std::size_t* pivot,
+                   std::size_t s0, std::size_t s1)
+{
+  for (std::size_t j = k; j < k+kb; ++j) {
+    // choose the largest entry of column j as pivot
+    std::size_t p = j;
+    for (std::size_t i = j+1; i < n; ++i)
+      if (std::abs(a[i*n + j]) > std::abs(a[p*n + j]))
+        p = i;
+    pivot[j] = p;
+    if (p != j)
+      std::swap_ranges(a + j*n + s0, a + j*n + s1, a + p*n + s0);
+
+    double const ajj = a[j*n + j];
+    assert(ajj != 0.0); // the matrix is singular
+    for (std::size_t i = j+1; i < n; ++i) {
+      double const lij = a[i*n + j] /= ajj;
+      for (std::size_t c = j+1; c < k+kb; ++c)
+        a[i*n + c] -= lij * a[j*n + c];
+    }
+  }
+}
+
+
+// Apply the row swaps of the panel [k, k+kb) to the columns [s0, s1)
+void swap_rows (double* a, std::size_t n, std::size_t k, std::size_t kb, std::size_t const* pivot,
+                std::size_t s0, std::size_t s1)
+{
+  for (std::size_t j = k; j < k+kb; ++j)
+    if (pivot[j] != j)
+      std::swap_ranges(a + j*n + s0, a + j*n + s1, a + pivot[j]*n + s0);
+}
+
+
+// Compute the block row U12 = L11^{-1} A12 of the rows [k, k+kb) and columns [first, last),
+// with L11 the unit lower triangle of the panel
+void solve_block_row (double* a, std::size_t n, std::size_t k, std::size_t kb,
+                      std::size_t first, std::size_t last)
+{
+  for (std::size_t c0 = first; c0 < last; c0 += column_tile) {
+    std::size_t const c1 = std::min(c0 + column_tile, last);
+    for (std::size_t i = k+1; i < k+kb; ++i) {
+      for (std::size_t r = k; r < i; ++r) {
+        double const lir = a[i*n + r];
+        for (std::size_t c = c0; c < c1; ++c)
+          a[i*n + c] -= lir * a[r*n + c];
+      }
+    }
+  }
+}
+
+
+// Update R rows of a matrix C with leading dimension ldc in the first `cols` columns:
+// C -= L * U, with L an R x kb matrix and U a kb x cols matrix, with leading dimensions ldl
+// and ldu. L is copied to the contiguous buffer l, column by column, and blocks of R x C
+// entries of C are accumulated in registers over the whole inner dimension kb, so only rows
+// of U are loaded from the cache.
+template <std::size_t R, std::size_t C = 8>
+void update_rows (double const* lsrc, std::size_t ldl, double const* u, std::size_t ldu,
+                  double* c, std::size_t ldc, std::size_t kb, std::size_t cols, double* l)
+{
+  for (std::size_t p = 0; p < kb; ++p)
+    for (std::size_t q = 0; q < R; ++q)
+      l[p*R + q] = lsrc[q*ldl + p];
+
+  std::size_t j = 0;
+  for (; j + C <= cols; j += C) {
+    double acc[R][C] = {};
+    for (std::size_t p = 0; p < kb; ++p) {
+      double const* up = u + p*ldu + j;
+      for (std::size_t q = 0; q < R; ++q)
+        for (std::size_t cc = 0; cc < C; ++cc)
+          acc[q][cc] += l[p*R + q] * up[cc];
+    }
+
+    for (std::size_t q = 0; q < R; ++q)
+      for (std::size_t cc = 0; cc < C; ++cc)
+        c[q*ldc + j + cc] -= acc[q][cc];
+  }
+
+  // remaining columns
+  for (std::size_t q = 0; q < R; ++q)
+    for (std::size_t p = 0; p < kb; ++p)
+      for (std::size_t jr = j; jr < cols; ++jr)
+        c[q*ldc + jr] -= l[p*R + q] * u[p*ldu + jr];
+}
+
+
+// Compute C -= L * U, with L a rows x kb matrix (kb <= block_size) and U a kb x cols matrix,
+// as a cache-blocked matrix-matrix product: a tile of columns of U is applied to all rows
+// before moving to the next tile.
+void update_block (double const* l, std::size_t ldl, double const* u, std::size_t ldu,
+                   double* c, std::size_t ldc, std::size_t rows, std::size_t kb, std::size_t cols)
+{
+  double buf[4 * LU::block_size];
+  for (std::size_t c0 = 0; c0 < cols; c0 += column_tile) {
+    std::size_t const w = std::min(column_tile, cols - c0);
+    std::size_t i = 0;
+    for (; i + 4 <= rows; i += 4)
+      update_rows<4>(l + i*ldl, ldl, u + c0, ldu, c + i*ldc + c0, ldc, kb, w, buf);
+    for (; i < rows; ++i)
+      update_rows<1>(l + i*ldl, ldl, u + c0, ldu, c + i*ldc + c0, ldc, kb, w, buf);
+  }
+}
+
+
+// Update the trailing matrix of the rows [k+kb, n) and columns [first, last),
+// A22 -= L21 * U12
+void update_trailing (double* a, std::size_t n, std::size_t k, std::size_t kb,
+                      std::size_t first, std::size_t last)
+{
+  update_block(a + (k+kb)*n + k, n, a + k*n + first, n, a + (k+kb)*n + first, n,
+               n-k-kb, kb, last-first);
+}
+
+// Forward and backward substitution with the n x n factor a for M right-hand sides stored
+// row-wise in x, row by row with the partial sums of all right-hand sides in registers
+template <std::size_t M>
+void substitute_rows (double const* a, std::size_t n, double* x)
+{
+  for (std::size_t i = 0; i < n; ++i) {
+    double f[M] = {};
+    for (std::size_t k = 0; k < i; ++k)
+      for (std::size_t c = 0; c < M; ++c)
+        f[c] += a[i*n + k] * x[k*M + c];
+    for (std::size_t c = 0; c < M; ++c)
+      x[i*M + c] -= f[c];
+  }
+
+  for (std::size_t i = n; i > 0; --i) {
+    double f[M] = {};
+    for (std::size_t k = i; k < n; ++k)
+      for (std::size_t c = 0; c < M; ++c)
+        f[c] += a[(i-1)*n + k] * x[k*M + c];
+    for (std::size_t c = 0; c < M; ++c)
+      x[(i-1)*M + c] = (x[(i-1)*M + c] - f[c]) / a[(i-1)*n + i-1];
+  }
+}
+
+} // end anonymous namespace
+
+
+constexpr std::size_t LU::block_size;
+
+
+// Blocked right-looking LU decomposition with partial pivoting. For each panel of
+// block_size columns: factorize the panel, compute the corresponding block row of U, and
+// update the trailing matrix by a matrix-matrix product.
 void LU::compute (DenseMatrix const& A)
 {
-  // check for symmetric matrices
+  // check for square matrices
+  assert(A.rows() == A.cols());
+  std::size_t n = A.rows();
+
+  // copy-assign the input matrix to the decomposition
+  decomposition_ = A;
+  pivot_.resize(n);
+
+  double* a = decomposition_.data();
+  for (std::size_t k = 0; k < n; k += block_size) {
+    std::size_t kb = std::min(block_size, n-k);
+    factor_panel(a, n, k, kb, pivot_.data(), 0, n);
+    solve_block_row(a, n, k, kb, k+kb, n);
+    update_trailing(a, n, k, kb, k+kb, n);
+  }
+}
+
+
+// Task-parallel blocked LU decomposition. The matrix is split into block columns of
+// block_size columns, and each step of the factorization is a task on block columns:
+// - panel(k): factorize the block column k, with row swaps restricted to this block column,
+// - update(k,j) for j > k: apply the row swaps of panel k to the block column j, compute
+//   its block of U and update its trailing part,
+// - swap(k,j) for j < k: apply the row swaps of panel k to the finished block column j.
+// The dependencies between the tasks are expressed on the block columns. Thus, the panel
+// k+1 can be factorized as soon as update(k,k+1) is finished, while the other updates of
+// step k are still running (look-ahead). The tasks on the critical path get a higher
+// priority. The tasks are scheduled by the OpenMP runtime on the threads of the team.
+void LU::compute_parallel (DenseMatrix const& A, int num_threads)
+{
+  // check for square matrices
   assert(A.rows() == A.cols());
+  assert(num_threads >= 1);
   std::size_t n = A.rows();
 
   // copy-assign the input matrix to the decomposition
   decomposition_ = A;
+  pivot_.resize(n);
+
+  double* a = decomposition_.data();
+  std::size_t* pivot = pivot_.data();
+  std::size_t blocks = (n + block_size - 1) / block_size;
+
+  // the dependencies of the tasks are expressed on the first entry a[kk*block_size] of each
+  // block column kk
+#ifdef _OPENMP
+#pragma omp parallel num_threads(num_threads) if(num_threads > 1)
+#pragma omp single
+#endif
+  for (std::size_t kk = 0; kk < blocks; ++kk) {
+    std::size_t k = kk*block_size;
+    std::size_t kb = std::min(block_size, n-k);
+
+#ifdef _OPENMP
+#pragma omp task depend(inout: a[kk*block_size]) priority(2)
+#endif
+    factor_panel(a, n, k, kb, pivot, k, k+kb);
 
-  for (std::size_t i = 0; i < n-1; ++i) {
-    for (std::size_t k = i+1; k < n; ++k) {
-      assert(std::abs(decomposition_(i,i)) > 1.e-10);
-      decomposition_(k,i) = decomposition_(k,i) / decomposition_(i,i);
-      for (std::size_t j = i+1; j < n; ++j)
-        decomposition_(k,j) -= decomposition_(k,i) * decomposition_(i,j);
+    for (std::size_t jj = kk+1; jj < blocks; ++jj) {
+      std::size_t j = jj*block_size;
+      std::size_t jb = std::min(block_size, n-j);
+#ifdef _OPENMP
+#pragma omp task depend(in: a[kk*block_size]) depend(inout: a[jj*block_size]) priority(jj == kk+1 ? 1 : 0)
+#endif
+      {
+        swap_rows(a, n, k, kb, pivot, j, j+jb);
+        solve_block_row(a, n, k, kb, j, j+jb);
+        update_trailing(a, n, k, kb, j, j+jb);
+      }
+    }
+
+    for (std::size_t jj = 0; jj < kk; ++jj) {
+      std::size_t j = jj*block_size;
+#ifdef _OPENMP
+#pragma omp task depend(in: a[kk*block_size]) depend(inout: a[jj*block_size])
+#endif
+      swap_rows(a, n, k, kb, pivot, j, j+block_size);
     }
   }
 }
@@ -31,22 +254,94 @@ void LU::apply (Vector const& b, Vector& x) const
   assert(decomposition_.rows() == x.size());
   assert(decomposition_.cols() == b.size());
 
-  // forward elimination
-  Vector y{x.size()};
-  for (std::size_t i = 0; i < y.size(); ++i) {
-    Vector::value_type f = 0;
-    for (std::size_t k = 0; k < i; ++k)
-      f += decomposition_(i,k) * y[k];
-    y[i] = b[i] - f;
+  x = b;
+  apply(x);
+}
+
+
+void LU::apply (Vector& x) const
+{
+  assert(decomposition_.rows() == x.size());
+  std::size_t n = x.size();
+
+  // apply the row permutation, x = P*x
+  for (std::size_t i = 0; i < n; ++i)
+    std::swap(x[i], x[pivot_[i]]);
+
+  substitute_rows<1>(decomposition_.data(), n, x.data());
+}
+
+
+void LU::apply (DenseMatrix const& B, DenseMatrix& X) const
+{
+  assert(decomposition_.cols() == B.rows());
+
+  X = B;
+  apply(X);
+}
+
+
+// Blocked forward and backward substitution for all columns of X at once. After a
+// diagonal block of block_size rows is solved, the remaining rows are updated by a
+// matrix-matrix product with the corresponding block column of L or U. Thus, each block
+// of the factor is loaded once per tile of column_tile right-hand sides.
+void LU::apply (DenseMatrix& X) const
+{
+  assert(decomposition_.rows() == X.rows());
+  std::size_t n = X.rows();
+  std::size_t m = X.cols();
+
+  double const* a = decomposition_.data();
+  double* x = X.data();
+
+  // apply the row permutation, X = P*X
+  for (std::size_t i = 0; i < n; ++i)
+    if (pivot_[i] != i)
+      std::swap_ranges(x + i*m, x + (i+1)*m, x + pivot_[i]*m);
+
+  // for less right-hand sides than a register block of update_rows, substitute row by row
+  switch (m) {
+    case 1: substitute_rows<1>(a, n, x); return;
+    case 2: substitute_rows<2>(a, n, x); return;
+    case 3: substitute_rows<3>(a, n, x); return;
+    case 4: substitute_rows<4>(a, n, x); return;
+    case 5: substitute_rows<5>(a, n, x); return;
+    case 6: substitute_rows<6>(a, n, x); return;
+    case 7: substitute_rows<7>(a, n, x); return;
+    default: break;
   }
 
-  // backward elimination
-  for (std::size_t j = 0; j < x.size(); ++j) {
-    std::size_t i = x.size()-j-1;
-    Vector::value_type f = 0;
-    for (std::size_t k = i+1; k < x.size(); ++k)
-      f += decomposition_(i,k) * x[k];
-    x[i] = (y[i] - f)/decomposition_(i,i);
+  // forward elimination with the unit lower triangular L
+  for (std::size_t k = 0; k < n; k += block_size) {
+    std::size_t kb = std::min(block_size, n-k);
+    for (std::size_t i = k+1; i < k+kb; ++i)
+      for (std::size_t r = k; r < i; ++r) {
+        double const lir = a[i*n + r];
+        for (std::size_t c = 0; c < m; ++c)
+          x[i*m + c] -= lir * x[r*m + c];
+      }
+
+    // X(k+kb:n,:) -= L(k+kb:n, k:k+kb) * X(k:k+kb,:)
+    update_block(a + (k+kb)*n + k, n, x + k*m, m, x + (k+kb)*m, m, n-k-kb, kb, m);
+  }
+
+  // backward elimination with the upper triangular U, from the last block upwards
+  for (std::size_t kk = (n + block_size - 1) / block_size; kk > 0; --kk) {
+    std::size_t k = (kk-1)*block_size;
+    std::size_t kb = std::min(block_size, n-k);
+    for (std::size_t i = k+kb; i > k; --i) {
+      for (std::size_t r = i; r < k+kb; ++r) {
+        double const uir = a[(i-1)*n + r];
+        for (std::size_t c = 0; c < m; ++c)
+          x[(i-1)*m + c] -= uir * x[r*m + c];
+      }
+      double const uii = a[(i-1)*n + i-1];
+      for (std::size_t c = 0; c < m; ++c)
+        x[(i-1)*m + c] /= uii;
+    }
+
+    // X(0:k,:) -= U(0:k, k:k+kb) * X(k:k+kb,:)
+    update_block(a + k, n, x + k*m, m, x, m, k, kb, m);
   }
 }
 
@@ -1,21 +1,43 @@
 #pragma once
 
+#include <vector>
+
 #include "DenseMatrix.hh"
 #include "Vector.hh"
 
 namespace scprog
 {
+  // LU decomposition with partial pivoting, P*A = L*U
   class LU
   {
+  public:
+    // number of columns of a panel in the blocked decomposition
+    static constexpr std::size_t block_size = 64;
+
   public:
     // decomposing the matrix m, without modifing it
     void compute (DenseMatrix const& A);
 
+    // decomposing the matrix m as compute(), with the blocked steps run as parallel tasks
+    // on num_threads threads. Requires OpenMP, otherwise the tasks run sequentially.
+    void compute_parallel (DenseMatrix const& A, int num_threads);
+
     // Solve the linear system A*x = b using the decomposed matrix
     void apply (Vector const& b, Vector& x) const;
 
+    // Solve the linear system A*x = b in place, with x = b on input. Does not allocate.
+    void apply (Vector& x) const;
+
+    // Solve the linear systems A*X = B for all columns of B at once, with blocked
+    // triangular solves
+    void apply (DenseMatrix const& B, DenseMatrix& X) const;
+
+    // Solve the linear systems A*X = B in place, with X = B on input. Does not allocate.
+    void apply (DenseMatrix& X) const;
+
   private:
     DenseMatrix decomposition_; // store the decomposition in this matrix
+    std::vector<std::size_t> pivot_; // row i was swapped with row pivot_[i] in step i
   };
 
 } // end namespace scprog
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cassert>
+
+#include "Tridiagonal.hh"
+
+namespace scprog {
+
+namespace {
+
+// number of interleaved systems swept together, such that their coefficients stay in the
+// L2 cache between the forward and the backward sweep
+constexpr std::size_t system_tile = 256;
+
+
+// Thomas decomposition of m interleaved tridiagonal systems of size n, entry i of system s
+// at index i*ld + s. Computes the inverse pivots d and the scaled super-diagonals u:
+//   d(i) = 1 / (diag(i) - lower(i) * u(i-1)),  u(i) = upper(i) * d(i)
+void thomas_factor (std::size_t n, std::size_t m, std::size_t ld, double const* lower,
+                    double const* diag, double const* upper, double* u, double* d)
+{
+  for (std::size_t s = 0; s < m; ++s) {
+    assert(diag[s] != 0.0); // zero pivot
+    d[s] = 1.0 / diag[s];
+    u[s] = upper[s] * d[s];
+  }
+
+  for (std::size_t i = 1; i < n; ++i)
+    for (std::size_t s = 0; s < m; ++s) {
+      double const p = diag[i*ld + s] - lower[i*ld + s] * u[(i-1)*ld + s];
+      assert(p != 0.0); // zero pivot
+      d[i*ld + s] = 1.0 / p;
+      u[i*ld + s] = upper[i*ld + s] * d[i*ld + s];
+    }
+}
+
+
+// Forward and backward sweep of the Thomas algorithm for m interleaved systems, in place
+void thomas_solve (std::size_t n, std::size_t m, std::size_t ld, double const* lower,
+                   double const* u, double const* d, double* x)
+{
+  for (std::size_t s = 0; s < m; ++s)
+    x[s] *= d[s];
+
+  for (std::size_t i = 1; i < n; ++i)
+    for (std::size_t s = 0; s < m; ++s)
+      x[i*ld + s] = (x[i*ld + s] - lower[i*ld + s] * x[(i-1)*ld + s]) * d[i*ld + s];
+
+  for (std::size_t i = n-1; i > 0; --i)
+    for (std::size_t s = 0; s < m; ++s)
+      x[(i-1)*ld + s] -= u[(i-1)*ld + s] * x[i*ld + s];
+}
+
+} // end anonymous namespace
+
+
+void Tridiagonal::compute (BandMatrix const& A)
+{
+  assert(A.lower() == 1 && A.upper() == 1);
+  std::size_t n = A.rows();
+
+  std::vector<double> diag(n), upper(n, 0.0);
+  lower_.assign(n, 0.0);
+  for (std::size_t i = 0; i < n; ++i) {
+    diag[i] = A(i,i);
+    if (i > 0)
+      lower_[i] = A(i,i-1);
+    if (i+1 < n)
+      upper[i] = A(i,i+1);
+  }
+
+  upper_.resize(n);
+  inv_diag_.resize(n);
+  if (n > 0)
+    thomas_factor(n, 1, 1, lower_.data(), diag.data(), upper.data(), upper_.data(), inv_diag_.data());
+}
+
+
+void Tridiagonal::apply (Vector const& b, Vector& x) const
+{
+  assert(inv_diag_.size() == x.size());
+  assert(inv_diag_.size() == b.size());
+
+  x = b;
+  apply(x);
+}
+
+
+void Tridiagonal::apply (Vector& x) const
+{
+  assert(inv_diag_.size() == x.size());
+  if (x.size() > 0)
+    thomas_solve(x.size(), 1, 1, lower_.data(), upper_.data(), inv_diag_.data(), x.data());
+}
+
+
+void BatchedTridiagonal::compute (DenseMatrix const& lower, DenseMatrix const& diag,
+                                  DenseMatrix const& upper)
+{
+  assert(lower.rows() == diag.rows() && upper.rows() == diag.rows());
+  assert(lower.cols() == diag.cols() && upper.cols() == diag.cols());
+  std::size_t n = diag.rows();
+  std::size_t m = diag.cols();
+
+  // the storage is reused for systems of the same shape
+  lower_ = lower;
+  if (upper_.rows() != n || upper_.cols() != m) {
+    upper_ = DenseMatrix{n, m};
+    inv_diag_ = DenseMatrix{n, m};
+  }
+  if (n == 0)
+    return;
+
+  for (std::size_t s0 = 0; s0 < m; s0 += system_tile)
+    thomas_factor(n, std::min(system_tile, m - s0), m, lower_.data() + s0, diag.data() + s0,
+                  upper.data() + s0, upper_.data() + s0, inv_diag_.data() + s0);
+}
+
+
+void BatchedTridiagonal::apply (DenseMatrix const& B, DenseMatrix& X) const
+{
+  X = B;
+  apply(X);
+}
+
+
+void BatchedTridiagonal::apply (DenseMatrix& X) const
+{
+  assert(X.rows() == inv_diag_.rows() && X.cols() == inv_diag_.cols());
+  std::size_t n = X.rows();
+  std::size_t m = X.cols();
+  if (n == 0)
+    return;
+
+  for (std::size_t s0 = 0; s0 < m; s0 += system_tile)
+    thomas_solve(n, std::min(system_tile, m - s0), m, lower_.data() + s0, upper_.data() + s0,
+                 inv_diag_.data() + s0, X.data() + s0);
+}
+
+} // end namespace scprog
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+#include "BandMatrix.hh"
+#include "DenseMatrix.hh"
+#include "Vector.hh"
+
+namespace scprog
+{
+  // Thomas algorithm, i.e., LU decomposition without pivoting, for a tridiagonal matrix. It
+  // is stable for diagonally dominant and for symmetric positive definite matrices. The
+  // decomposition and a solve cost O(n) operations.
+  class Tridiagonal
+  {
+  public:
+    // decomposing the band matrix m with one sub- and one super-diagonal, without modifing it
+    void compute (BandMatrix const& A);
+
+    // Solve the linear system A*x = b using the decomposed matrix
+    void apply (Vector const& b, Vector& x) const;
+
+    // Solve the linear system A*x = b in place, with x = b on input. Does not allocate.
+    void apply (Vector& x) const;
+
+  private:
+    std::vector<double> lower_;     // the sub-diagonal of A
+    std::vector<double> upper_;     // the super-diagonal of U, scaled by the inverse pivot
+    std::vector<double> inv_diag_;  // the inverse pivots
+  };
+
+
+  // Thomas algorithm for m independent tridiagonal systems of size n. The coefficients and
+  // the right-hand sides of the systems are the columns of n x m matrices, so entry i of
+  // all systems is stored contiguously and the sweeps vectorize over the systems.
+  class BatchedTridiagonal
+  {
+  public:
+    // decomposing the m systems with sub-diagonals lower(1:n,s), diagonals diag(0:n,s), and
+    // super-diagonals upper(0:n-1,s), s = 0,...,m-1. The entries lower(0,s) and
+    // upper(n-1,s) are not used.
+    void compute (DenseMatrix const& lower, DenseMatrix const& diag, DenseMatrix const& upper);
+
+    // Solve the linear systems A_s * X(:,s) = B(:,s) for all systems s
+    void apply (DenseMatrix const& B, DenseMatrix& X) const;
+
+    // Solve the linear systems in place, with X = B on input. Does not allocate.
+    void apply (DenseMatrix& X) const;
+
+  private:
+    DenseMatrix lower_;     // the sub-diagonals
+    DenseMatrix upper_;     // the super-diagonals of U, scaled by the inverse pivots
+    DenseMatrix inv_diag_;  // the inverse pivots
+  };
+
+} // end namespace scprog
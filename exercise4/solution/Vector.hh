@@ -38,6 +38,18 @@ namespace scprog
       return data_.size();
     }
 
+    // pointer to the contiguous vector entries
+    value_type* data ()
+    {
+      return data_.data();
+    }
+
+    // const pointer to the contiguous vector entries
+    value_type const* data () const
+    {
+      return data_.data();
+    }
+
   private:
     std::vector<double> data_;
   };
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include "BandLU.hh"
+#include "BandMatrix.hh"
+#include "DenseMatrix.hh"
+#include "LU.hh"
+#include "Tridiagonal.hh"
+#include "Vector.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Return the relative residual |b - A*x| / |b| in the maximum norm
+template <class Matrix>
+double residual (Matrix const& A, Vector const& x, Vector const& b)
+{
+  Vector Ax{b.size()};
+  A.mv(x, Ax);
+  double r = 0, nb = 0;
+  for (std::size_t i = 0; i < b.size(); ++i) {
+    r = std::max(r, std::abs(b[i] - Ax[i]));
+    nb = std::max(nb, std::abs(b[i]));
+  }
+  return r / nb;
+}
+
+// Decompose A, solve for b and print the time of the decomposition and of the solve
+template <class Solver, class Matrix>
+void run (char const* name, Matrix const& A, Vector const& b)
+{
+  Solver solver;
+  Vector x{b.size()};
+  Timer t;
+  solver.compute(A);
+  double time_compute = t.elapsed();
+  t.reset();
+  solver.apply(b, x);
+  double time_apply = t.elapsed();
+  std::cout << "  " << name << "compute " << (time_compute*1000) << " ms, apply "
+            << (time_apply*1000) << " ms, residual " << residual(A, x, b) << "\n";
+}
+
+int main (int argc, char** argv)
+{
+  // the dense LU is only run up to the size dense_max
+  std::size_t dense_max = argc > 1 ? std::atoi(argv[1]) : 2000;
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  // 1. the tridiagonal matrix of task3 and task2: 2 on the diagonal, -1 on the off-diagonals
+  std::cout << "tridiagonal matrix [-1, 2, -1]:\n";
+  for (std::size_t n : {500, 2000, 8000, 1000000}) {
+    DenseMatrix D{n <= dense_max ? n : 0, n <= dense_max ? n : 0};
+    BandMatrix A{n,1,1};
+    for (std::size_t i = 0; i < n; ++i) {
+      A(i,i) = 2.0;
+      if (i > 0)
+        A(i,i-1) = -1.0;
+      if (i+1 < n)
+        A(i,i+1) = -1.0;
+      if (n <= dense_max)
+        for (std::size_t j = (i > 0 ? i-1 : 0); j < std::min(n, i+2); ++j)
+          D(i,j) = A(i,j);
+    }
+    Vector b{n};
+    for (std::size_t i = 0; i < n; ++i)
+      b[i] = 1.0;
+
+    std::cout << " n = " << n << ":\n";
+    if (n <= dense_max)
+      run<LU>("LU:          ", D, b);
+    run<BandLU>("BandLU:      ", A, b);
+    run<Tridiagonal>("Tridiagonal: ", A, b);
+  }
+
+  // 2. random diagonally dominant band matrices, the time per row grows like bw^2
+  std::size_t n = 100000;
+  std::cout << "\nrandom band matrices, n = " << n << ":\n";
+  for (std::size_t bw : {1, 2, 4, 8, 16, 32}) {
+    BandMatrix A{n,bw,bw};
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = (i > bw ? i-bw : 0); j < std::min(n, i+bw+1); ++j)
+        A(i,j) = dist(gen) + (i == j ? 2.0*bw : 0.0);
+    Vector b{n}, x{n};
+    for (std::size_t i = 0; i < n; ++i)
+      b[i] = dist(gen);
+
+    BandLU lu;
+    Timer t;
+    lu.compute(A);
+    double time_compute = t.elapsed();
+    t.reset();
+    lu.apply(b, x);
+    double time_apply = t.elapsed();
+    std::cout << "  bw = " << bw << ": compute " << (time_compute*1000) << " ms ("
+              << (time_compute / (n*bw*bw) * 1.e9) << " ns per n*bw^2), apply "
+              << (time_apply*1000) << " ms (" << (time_apply / (n*bw) * 1.e9) << " ns per n*bw)"
+              << ", residual " << residual(A, x, b) << "\n";
+  }
+
+  // 3. many independent small tridiagonal systems
+  std::size_t size = 64, m = 10000;
+  std::cout << "\n" << m << " tridiagonal systems of size " << size << ":\n";
+  DenseMatrix lower{size,m}, diag{size,m}, upper{size,m}, B{size,m}, X{size,m};
+  for (std::size_t i = 0; i < size; ++i)
+    for (std::size_t s = 0; s < m; ++s) {
+      lower(i,s) = dist(gen);
+      upper(i,s) = dist(gen);
+      diag(i,s) = 3.0 + dist(gen);
+      B(i,s) = dist(gen);
+    }
+
+  // one system after another
+  Timer t;
+  BandMatrix A{size,1,1};
+  Vector b{size}, x{size};
+  Tridiagonal tri;
+  for (std::size_t s = 0; s < m; ++s) {
+    for (std::size_t i = 0; i < size; ++i) {
+      A(i,i) = diag(i,s);
+      if (i > 0)
+        A(i,i-1) = lower(i,s);
+      if (i+1 < size)
+        A(i,i+1) = upper(i,s);
+      b[i] = B(i,s);
+    }
+    tri.compute(A);
+    tri.apply(b, x);
+  }
+  double time_single = t.elapsed();
+
+  // all systems at once, the second time with the storage of the first
+  BatchedTridiagonal batched;
+  double time_batched[2];
+  for (double& time : time_batched) {
+    t.reset();
+    batched.compute(lower, diag, upper);
+    batched.apply(B, X);
+    time = t.elapsed();
+  }
+
+  double diff = 0;
+  for (std::size_t i = 0; i < size; ++i)
+    diff = std::max(diff, std::abs(X(i,m-1) - x[i]));
+  std::cout << "  Tridiagonal:                    " << (time_single*1000) << " ms\n"
+            << "  BatchedTridiagonal:             " << (time_batched[0]*1000) << " ms, speedup "
+            << (time_single / time_batched[0]) << "\n"
+            << "  BatchedTridiagonal, reused:     " << (time_batched[1]*1000) << " ms, speedup "
+            << (time_single / time_batched[1]) << ", max difference (last system) " << diff << "\n";
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -march=native DenseMatrix.cc Vector.cc LU.cc BandMatrix.cc BandLU.cc Tridiagonal.cc benchmark_band.cc -o benchmark_band
+// and run with the maximal size for the dense LU, e.g. ./benchmark_band 4000
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include "Cholesky.hh"
+#include "DenseMatrix.hh"
+#include "LU.hh"
+#include "Vector.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Return the relative residual |b - A*x| / |b| in the maximum norm
+double residual (DenseMatrix const& A, Vector const& x, Vector const& b)
+{
+  Vector Ax{b.size()};
+  A.mv(x, Ax);
+  double r = 0, nb = 0;
+  for (std::size_t i = 0; i < b.size(); ++i) {
+    r = std::max(r, std::abs(b[i] - Ax[i]));
+    nb = std::max(nb, std::abs(b[i]));
+  }
+  return r / nb;
+}
+
+// Factorize A, solve for b and print the time of the decomposition
+template <class Solver>
+double run (char const* name, DenseMatrix const& A, Vector const& b, double flops, double bytes)
+{
+  Solver solver;
+  Vector x{b.size()};
+  Timer t;
+  solver.compute(A);
+  double time = t.elapsed();
+  solver.apply(b, x);
+  std::cout << "  " << name << time << " s, " << (flops / time / 1.e9) << " GFlop/s, "
+            << (bytes / 1.e6) << " MB, residual " << residual(A, x, b) << "\n";
+  return time;
+}
+
+int main (int argc, char** argv)
+{
+  std::size_t n_max = argc > 1 ? std::atoi(argv[1]) : 4000;
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  for (std::size_t n : {500, 1000, 2000, 4000, 8000}) {
+    if (n > n_max)
+      break;
+
+    // a random symmetric, diagonally dominant and thus positive definite matrix
+    DenseMatrix A{n,n};
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = 0; j < i; ++j)
+        A(i,j) = A(j,i) = dist(gen);
+      A(i,i) = n;
+    }
+    Vector b{n};
+    for (std::size_t i = 0; i < n; ++i)
+      b[i] = dist(gen);
+
+    // flops of the decompositions and bytes of the stored factors
+    double N = n;
+    double flops_lu = 2.0/3.0 * N*N*N, flops_chol = 1.0/3.0 * N*N*N;
+    double bytes_lu = 8*N*N, bytes_chol = 8*N*(N+1)/2;
+
+    std::cout << "n = " << n << ":\n";
+    double time_lu = run<LU>("LU:       ", A, b, flops_lu, bytes_lu);
+    double time_chol = run<Cholesky>("Cholesky: ", A, b, flops_chol, bytes_chol);
+    double time_ldlt = run<LDLT>("LDL^T:    ", A, b, flops_chol, bytes_chol);
+    std::cout << "  speedup vs. LU: Cholesky " << (time_lu / time_chol)
+              << ", LDL^T " << (time_lu / time_ldlt)
+              << ", flop and memory ratio " << (flops_lu / flops_chol) << "\n";
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -march=native DenseMatrix.cc Vector.cc LU.cc Cholesky.cc benchmark_cholesky.cc -o benchmark_cholesky
+// and run with the maximal size, e.g. ./benchmark_cholesky 8000
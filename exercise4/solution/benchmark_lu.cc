@@ -0,0 +1,96 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include "DenseMatrix.hh"
+#include "LU.hh"
+#include "Vector.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// The previous LU::compute: ikj loop without pivoting, for comparison
+void lu_reference (DenseMatrix& A)
+{
+  std::size_t n = A.rows();
+  for (std::size_t i = 0; i < n-1; ++i) {
+    for (std::size_t k = i+1; k < n; ++k) {
+      A(k,i) = A(k,i) / A(i,i);
+      for (std::size_t j = i+1; j < n; ++j)
+        A(k,j) -= A(k,i) * A(i,j);
+    }
+  }
+}
+
+// Return the relative residual |b - A*x| / |b| in the maximum norm
+double residual (DenseMatrix const& A, Vector const& x, Vector const& b)
+{
+  Vector Ax{b.size()};
+  A.mv(x, Ax);
+  double r = 0, nb = 0;
+  for (std::size_t i = 0; i < b.size(); ++i) {
+    r = std::max(r, std::abs(b[i] - Ax[i]));
+    nb = std::max(nb, std::abs(b[i]));
+  }
+  return r / nb;
+}
+
+int main (int argc, char** argv)
+{
+  // the reference loop is only run up to the size ref_max
+  std::size_t n_max = argc > 1 ? std::atoi(argv[1]) : 8000;
+  std::size_t ref_max = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  for (std::size_t n : {500, 1000, 2000, 4000, 8000}) {
+    if (n > n_max)
+      break;
+
+    // a random matrix, made diagonally dominant for the reference without pivoting
+    DenseMatrix A{n,n};
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = 0; j < n; ++j)
+        A(i,j) = dist(gen);
+    Vector b{n}, x{n};
+    for (std::size_t i = 0; i < n; ++i)
+      b[i] = dist(gen);
+
+    double flops = 2.0/3.0 * double(n)*n*n;
+    std::cout << "n = " << n << ":\n";
+
+    // random matrix, requires pivoting
+    Timer t;
+    LU lu;
+    lu.compute(A);
+    double time = t.elapsed();
+    lu.apply(b, x);
+    std::cout << "  blocked LU, random matrix:      " << time << " s, "
+              << (flops / time / 1.e9) << " GFlop/s, residual " << residual(A, x, b) << "\n";
+
+    for (std::size_t i = 0; i < n; ++i)
+      A(i,i) += n;
+
+    t.reset();
+    lu.compute(A);
+    time = t.elapsed();
+    lu.apply(b, x);
+    std::cout << "  blocked LU, diagonally dominant: " << time << " s, "
+              << (flops / time / 1.e9) << " GFlop/s, residual " << residual(A, x, b) << "\n";
+
+    if (n <= ref_max) {
+      DenseMatrix B{A};
+      t.reset();
+      lu_reference(B);
+      double time_ref = t.elapsed();
+      std::cout << "  ikj loop,   diagonally dominant: " << time_ref << " s, "
+                << (flops / time_ref / 1.e9) << " GFlop/s, speedup " << (time_ref / time) << "\n";
+    }
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -march=native DenseMatrix.cc Vector.cc LU.cc benchmark_lu.cc -o benchmark_lu
+// and run with the maximal size and the maximal size for the reference loop, e.g. ./benchmark_lu 8000 2000
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "DenseMatrix.hh"
+#include "LU.hh"
+#include "Vector.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+int main (int argc, char** argv)
+{
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 2000;
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  DenseMatrix A{n,n};
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+      A(i,j) = dist(gen);
+
+  LU lu;
+  lu.compute(A);
+
+  std::cout << "n = " << n << "\n";
+  for (std::size_t m : {1, 4, 16, 64, 256}) {
+    // m right-hand sides, as columns of a matrix and as separate vectors
+    DenseMatrix B{n,m}, X{n,m};
+    std::vector<Vector> b(m, Vector{n}), x(m, Vector{n});
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = 0; j < m; ++j)
+        b[j][i] = B(i,j) = dist(gen);
+
+    // one vector at a time
+    Timer t;
+    for (std::size_t j = 0; j < m; ++j)
+      lu.apply(b[j], x[j]);
+    double time_single = t.elapsed();
+
+    // all vectors at once
+    t.reset();
+    lu.apply(B, X);
+    double time_block = t.elapsed();
+
+    double diff = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = 0; j < m; ++j)
+        diff = std::max(diff, std::abs(X(i,j) - x[j][i]));
+
+    double flops = 2.0 * double(n)*n*m;
+    std::cout << "  m = " << m << ": single " << time_single << " s ("
+              << (flops / time_single / 1.e9) << " GFlop/s), block " << time_block << " s ("
+              << (flops / time_block / 1.e9) << " GFlop/s), speedup " << (time_single / time_block)
+              << ", max difference " << diff << "\n";
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -march=native DenseMatrix.cc Vector.cc LU.cc benchmark_lu_apply.cc -o benchmark_lu_apply
+// and run with the matrix size, e.g. ./benchmark_lu_apply 4000
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "DenseMatrix.hh"
+#include "LU.hh"
+#include "Vector.hh"
+#include "Timer.hh"
+
+using namespace scprog;
+
+// Return the relative residual |b - A*x| / |b| in the maximum norm
+double residual (DenseMatrix const& A, Vector const& x, Vector const& b)
+{
+  Vector Ax{b.size()};
+  A.mv(x, Ax);
+  double r = 0, nb = 0;
+  for (std::size_t i = 0; i < b.size(); ++i) {
+    r = std::max(r, std::abs(b[i] - Ax[i]));
+    nb = std::max(nb, std::abs(b[i]));
+  }
+  return r / nb;
+}
+
+int main (int argc, char** argv)
+{
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 4000;
+#ifdef _OPENMP
+  int max_threads = argc > 2 ? std::atoi(argv[2]) : omp_get_num_procs();
+#else
+  int max_threads = argc > 2 ? std::atoi(argv[2]) : 1;
+#endif
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  DenseMatrix A{n,n};
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+      A(i,j) = dist(gen);
+  Vector b{n}, x{n};
+  for (std::size_t i = 0; i < n; ++i)
+    b[i] = dist(gen);
+
+  double flops = 2.0/3.0 * double(n)*n*n;
+  std::cout << "n = " << n << "\n";
+
+  // sequential blocked LU as baseline
+  LU lu;
+  Timer t;
+  lu.compute(A);
+  double time_seq = t.elapsed();
+  lu.apply(b, x);
+  std::cout << "  compute:             " << time_seq << " s, "
+            << (flops / time_seq / 1.e9) << " GFlop/s, residual " << residual(A, x, b) << "\n";
+
+  // strong scaling of the task-parallel LU, for 1, 2, 4, ..., max_threads threads
+  double time_1 = 0;
+  for (int p = 1;; p = std::min(2*p, max_threads)) {
+    t.reset();
+    lu.compute_parallel(A, p);
+    double time = t.elapsed();
+    if (p == 1)
+      time_1 = time;
+    lu.apply(b, x);
+    std::cout << "  compute_parallel(" << p << "): " << time << " s, "
+              << (flops / time / 1.e9) << " GFlop/s, speedup " << (time_1 / time)
+              << ", efficiency " << (time_1 / time / p) << ", residual " << residual(A, x, b) << "\n";
+    if (p == max_threads)
+      break;
+  }
+}
+
+// compile with:
+// c++ -std=c++14 -O3 -DNDEBUG -march=native -fopenmp DenseMatrix.cc Vector.cc LU.cc benchmark_lu_threads.cc -o benchmark_lu_threads
+// and run with the matrix size and the maximal number of threads, e.g. ./benchmark_lu_threads 8000 64